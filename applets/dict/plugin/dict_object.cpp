@@ -5,6 +5,7 @@
  */
 
 #include "dict_object.h"
+#include "dictddatabase.h"
 #include <KLocalizedString>
 #include <QDebug>
 #include <QQuickWebEngineProfile>
@@ -51,6 +52,17 @@ void DictObject::lookup(const QString &word)
 
     if (!m_source.isEmpty()) {
         m_dataEngine->disconnectSource(m_source, this);
+        m_source.clear();
+    }
+
+    // If the dictionary is installed locally and knows the word, there is no need to ask the server
+    if (const auto database = DictdDatabase::find(m_selectedDict)) {
+        const QString html = database->lookup(word).value(QStringLiteral("text")).toString();
+        if (!html.isEmpty()) {
+            Q_EMIT searchInProgress();
+            Q_EMIT definitionFound(html);
+            return;
+        }
     }
 
     if (!newSource.isEmpty()) {
@@ -15,6 +15,8 @@
 #include <QUrl>
 
 #include <KPackage/PackageLoader>
+#include <KPluginFactory>
+#include <KPluginLoader>
 #include <Plasma/DataContainer>
 
 #include "cachedprovider.h"
@@ -30,6 +32,9 @@ ComicEngine::ComicEngine(QObject *parent, const QVariantList &args)
 
 ComicEngine::~ComicEngine()
 {
+    // the providers would only be deleted after the engine, too late to wait for their scripts
+    qDeleteAll(findChildren<ComicProvider *>(QString(), Qt::FindDirectChildrenOnly));
+    ComicProviderKross::waitForDetachedThreads();
 }
 
 void ComicEngine::init()
@@ -148,8 +153,14 @@ bool ComicEngine::updateSourceEvent(const QString &identifier)
         }
         args << QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("plasma/comics/") + parts[0] + QLatin1String("/metadata.desktop"));
 
-        // provider = service->createInstance<ComicProvider>(this, args);
-        provider = new ComicProviderKross(this, args);
+        // packages can ship a compiled provider instead of a script
+        const QString plugin = pkg.metadata().value(QStringLiteral("X-KDE-PlasmaComicProvider-Plugin"));
+        if (!plugin.isEmpty()) {
+            provider = createNativeProvider(plugin, args);
+        }
+        if (!provider) {
+            provider = new ComicProviderKross(this, args);
+        }
         if (!provider) {
             setData(identifier, QLatin1String("Error"), true);
             return false;
@@ -302,6 +313,23 @@ void ComicEngine::setComicData(ComicProvider *provider)
     setData(identifier, QLatin1String("Error"), false);
 }
 
+ComicProvider *ComicEngine::createNativeProvider(const QString &plugin, const QVariantList &args)
+{
+    // every strip of a comic is fetched by a provider of its own, so load the plugin only for the first one
+    KPluginFactory *factory = m_pluginFactories.value(plugin);
+    if (!factory) {
+        KPluginLoader loader(QLatin1String("plasma/comic/") + plugin);
+        factory = loader.factory();
+        if (!factory) {
+            qWarning() << "Could not load the comic provider plugin" << plugin << loader.errorString();
+            return nullptr;
+        }
+        m_pluginFactories.insert(plugin, factory);
+    }
+
+    return factory->create<ComicProvider>(this, args);
+}
+
 QString ComicEngine::lastCachedIdentifier(const QString &identifier) const
 {
     const QString id = identifier.left(identifier.indexOf(QLatin1Char(':')));
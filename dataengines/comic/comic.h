@@ -12,6 +12,7 @@
 #include <QNetworkConfigurationManager>
 
 class ComicProvider;
+class KPluginFactory;
 
 /**
  * This class provides the comic strip.
@@ -25,6 +26,10 @@ class ComicProvider;
  *   xkcd:378
  * if the suffix is empty the latest comic will be returned
  *
+ * Comics are provided by the script of their package, run through Kross,
+ * unless the package names a compiled ComicProvider plugin in
+ * X-KDE-PlasmaComicProvider-Plugin, which is loaded from the plasma/comic
+ * plugin directory instead.
  */
 class ComicEngine : public Plasma::DataEngine
 {
@@ -53,9 +58,11 @@ private:
     bool mEmptySuffix;
     void setComicData(ComicProvider *provider);
     QString lastCachedIdentifier(const QString &identifier) const;
+    ComicProvider *createNativeProvider(const QString &plugin, const QVariantList &args);
     QString mIdentifierError;
     QStringList mProviders;
     QHash<QString, ComicProvider *> m_jobs;
+    QHash<QString, KPluginFactory *> m_pluginFactories;
     QNetworkConfigurationManager m_networkConfigurationManager;
 };
 
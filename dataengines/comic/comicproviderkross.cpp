@@ -7,47 +7,129 @@
 #include "comicproviderkross.h"
 #include "comic_package.h"
 #include <KPackage/PackageLoader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+
+#include <utility>
 
 KPackage::PackageStructure *ComicProviderKross::m_packageStructure(nullptr);
+static QMutex s_packageStructureMutex;
+// threads of deleted providers, only used in the thread of the engine
+static QList<QThread *> s_detachedThreads;
 
 ComicProviderKross::ComicProviderKross(QObject *parent, const QVariantList &args)
     : ComicProvider(parent, args)
-    , m_wrapper(this)
+    , m_thread(new QThread)
+    , m_wrapper(new ComicProviderWrapper(this))
 {
+    qRegisterMetaType<ComicScriptResult>();
+
+    // the interpreters are looked up once, here, the scripts only read the list
+    ComicProviderWrapper::extensions();
+    m_result.identifier = m_wrapper->identifierVariant();
+
+    m_wrapper->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_wrapper, &QObject::deleteLater);
+
+    connect(m_wrapper, &ComicProviderWrapper::pageRequested, this, [this](const QUrl &url, int id, const QVariantMap &infos) {
+        MetaInfos map;
+        for (auto it = infos.begin(), end = infos.end(); it != end; ++it) {
+            map[it.key()] = it.value().toString();
+        }
+        requestPage(url, id, map);
+    });
+    connect(m_wrapper, &ComicProviderWrapper::redirectedUrlRequested, this, [this](const QUrl &url, int id, const QVariantMap &infos) {
+        MetaInfos map;
+        for (auto it = infos.begin(), end = infos.end(); it != end; ++it) {
+            map[it.key()] = it.value().toString();
+        }
+        requestRedirectedUrl(url, id, map);
+    });
+    connect(m_wrapper, &ComicProviderWrapper::scriptFinished, this, &ComicProviderKross::scriptFinished);
+    connect(m_wrapper, &ComicProviderWrapper::scriptError, this, &ComicProviderKross::scriptError);
+
+    m_thread->setObjectName(QLatin1String("comic:") + pluginName());
+    m_thread->start();
+
+    // whether this is the current strip is only set after construction
+    QTimer::singleShot(0, this, [this]() {
+        ComicProviderWrapper *wrapper = m_wrapper;
+        const bool identifierSpecified = !isCurrent();
+        QMetaObject::invokeMethod(
+            wrapper,
+            [wrapper, identifierSpecified]() {
+                wrapper->start(identifierSpecified);
+            },
+            Qt::QueuedConnection);
+    });
 }
 
 ComicProviderKross::~ComicProviderKross()
 {
+    // a script function may still be running, the thread finishes on its own and
+    // deletes the wrapper on the way
+    m_wrapper->disconnect(this);
+    QThread *thread = m_thread;
+    s_detachedThreads.append(thread);
+    connect(thread, &QThread::finished, thread, [thread]() {
+        s_detachedThreads.removeOne(thread);
+        thread->deleteLater();
+    });
+    thread->quit();
+}
+
+void ComicProviderKross::waitForDetachedThreads()
+{
+    const QList<QThread *> threads = std::exchange(s_detachedThreads, {});
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void ComicProviderKross::scriptFinished(const ComicScriptResult &result)
+{
+    m_result = result;
+    Q_EMIT finished(this);
+}
+
+void ComicProviderKross::scriptError(const ComicScriptResult &result)
+{
+    m_result = result;
+    Q_EMIT error(this);
 }
 
 bool ComicProviderKross::isLeftToRight() const
 {
-    return m_wrapper.isLeftToRight();
+    return m_result.isLeftToRight;
 }
 
 bool ComicProviderKross::isTopToBottom() const
 {
-    return m_wrapper.isTopToBottom();
+    return m_result.isTopToBottom;
 }
 
 ComicProvider::IdentifierType ComicProviderKross::identifierType() const
 {
-    return m_wrapper.identifierType();
+    // only depends on the metadata, which does not change
+    return m_wrapper->identifierType();
 }
 
 QUrl ComicProviderKross::websiteUrl() const
 {
-    return QUrl(m_wrapper.websiteUrl());
+    return QUrl(m_result.websiteUrl);
 }
 
 QUrl ComicProviderKross::shopUrl() const
 {
-    return QUrl(m_wrapper.shopUrl());
+    return QUrl(m_result.shopUrl);
 }
 
 QImage ComicProviderKross::image() const
 {
-    return m_wrapper.comicImage();
+    return m_result.image;
 }
 
 QString ComicProviderKross::identifierToString(const QVariant &identifier) const
@@ -66,51 +148,76 @@ QString ComicProviderKross::identifierToString(const QVariant &identifier) const
 
 QString ComicProviderKross::identifier() const
 {
-    return pluginName() + QLatin1Char(':') + identifierToString(m_wrapper.identifierVariant());
+    return pluginName() + QLatin1Char(':') + identifierToString(m_result.identifier);
 }
 
 QString ComicProviderKross::nextIdentifier() const
 {
-    return identifierToString(m_wrapper.nextIdentifierVariant());
+    return identifierToString(m_result.nextIdentifier);
 }
 
 QString ComicProviderKross::previousIdentifier() const
 {
-    return identifierToString(m_wrapper.previousIdentifierVariant());
+    return identifierToString(m_result.previousIdentifier);
 }
 
 QString ComicProviderKross::firstStripIdentifier() const
 {
-    return identifierToString(m_wrapper.firstIdentifierVariant());
+    return identifierToString(m_result.firstIdentifier);
 }
 
 QString ComicProviderKross::stripTitle() const
 {
-    return m_wrapper.title();
+    return m_result.title;
 }
 
 QString ComicProviderKross::additionalText() const
 {
-    return m_wrapper.additionalText();
+    return m_result.additionalText;
+}
+
+QString ComicProviderKross::comicAuthor() const
+{
+    return m_result.comicAuthor;
 }
 
 void ComicProviderKross::pageRetrieved(int id, const QByteArray &data)
 {
-    m_wrapper.pageRetrieved(id, data);
+    // the page is decoded for the script in its thread as well
+    ComicProviderWrapper *wrapper = m_wrapper;
+    QMetaObject::invokeMethod(
+        wrapper,
+        [wrapper, id, data]() {
+            wrapper->pageRetrieved(id, data);
+        },
+        Qt::QueuedConnection);
 }
 
 void ComicProviderKross::pageError(int id, const QString &message)
 {
-    m_wrapper.pageError(id, message);
+    ComicProviderWrapper *wrapper = m_wrapper;
+    QMetaObject::invokeMethod(
+        wrapper,
+        [wrapper, id, message]() {
+            wrapper->pageError(id, message);
+        },
+        Qt::QueuedConnection);
 }
 
 void ComicProviderKross::redirected(int id, const QUrl &newUrl)
 {
-    m_wrapper.redirected(id, newUrl);
+    ComicProviderWrapper *wrapper = m_wrapper;
+    QMetaObject::invokeMethod(
+        wrapper,
+        [wrapper, id, newUrl]() {
+            wrapper->redirected(id, newUrl);
+        },
+        Qt::QueuedConnection);
 }
 
 KPackage::PackageStructure *ComicProviderKross::packageStructure()
 {
+    QMutexLocker locker(&s_packageStructureMutex);
     if (!m_packageStructure) {
         m_packageStructure = KPackage::PackageLoader::self()->loadPackageStructure(QStringLiteral("Plasma/Comic"));
     }
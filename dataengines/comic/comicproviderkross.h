@@ -14,6 +14,12 @@
 #include <QImage>
 #include <QUrl>
 
+class QThread;
+
+/**
+ * This class provides the comic of a package with a script. The script is
+ * run by a ComicProviderWrapper in a thread of its own.
+ */
 class ComicProviderKross : public ComicProvider
 {
     friend class ComicProviderWrapper;
@@ -25,6 +31,12 @@ public:
 
     static KPackage::PackageStructure *packageStructure();
 
+    /**
+     * Waits for the scripts of the deleted providers to stop. Their threads
+     * run code of the engine, so this has to be done before it is unloaded.
+     */
+    static void waitForDetachedThreads();
+
     bool isLeftToRight() const override;
     bool isTopToBottom() const override;
     IdentifierType identifierType() const override;
@@ -37,6 +49,7 @@ public:
     QString firstStripIdentifier() const override;
     QString stripTitle() const override;
     QString additionalText() const override;
+    QString comicAuthor() const override;
 
 protected:
     void pageRetrieved(int id, const QByteArray &data) override;
@@ -45,7 +58,13 @@ protected:
     QString identifierToString(const QVariant &identifier) const;
 
 private:
-    mutable ComicProviderWrapper m_wrapper;
+    void scriptFinished(const ComicScriptResult &result);
+    void scriptError(const ComicScriptResult &result);
+
+    QThread *m_thread;
+    ComicProviderWrapper *m_wrapper;
+    // what the script has found out so far
+    ComicScriptResult m_result;
     static KPackage::PackageStructure *m_packageStructure;
 };
 
@@ -16,7 +16,6 @@
 #include <QPainter>
 #include <QStandardPaths>
 #include <QTextCodec>
-#include <QTimer>
 #include <QUrl>
 
 QStringList ComicProviderWrapper::mExtensions;
@@ -81,6 +80,99 @@ QImage ImageWrapper::read()
     return mImageReader.read();
 }
 
+PageWrapper::PageWrapper(QObject *parent, const QByteArray &data, const QByteArray &textCodec)
+    : QObject(parent)
+    , mData(data)
+    , mTextCodecName(textCodec)
+{
+}
+
+QTextCodec *PageWrapper::codec() const
+{
+    if (!mCodec) {
+        if (!mTextCodecName.isEmpty()) {
+            mCodec = QTextCodec::codecForName(mTextCodecName);
+        }
+        if (!mCodec) {
+            mCodec = QTextCodec::codecForHtml(mData);
+        }
+    }
+    return mCodec;
+}
+
+QByteArray PageWrapper::encode(const QString &text) const
+{
+    return codec()->fromUnicode(text);
+}
+
+int PageWrapper::length() const
+{
+    return mData.size();
+}
+
+QByteArray PageWrapper::rawData() const
+{
+    return mData;
+}
+
+QString PageWrapper::textCodec() const
+{
+    return QString::fromLatin1(codec()->name());
+}
+
+int PageWrapper::indexOf(const QString &text, int from) const
+{
+    return mData.indexOf(encode(text), from);
+}
+
+int PageWrapper::lastIndexOf(const QString &text, int from) const
+{
+    return mData.lastIndexOf(encode(text), from);
+}
+
+bool PageWrapper::contains(const QString &text) const
+{
+    return indexOf(text) != -1;
+}
+
+QString PageWrapper::mid(int position, int length) const
+{
+    if (position < 0 || position >= mData.size()) {
+        return QString();
+    }
+    if (length < 0 || position + length > mData.size()) {
+        length = mData.size() - position;
+    }
+
+    // decode the slice in place, without copying the bytes first
+    return codec()->toUnicode(mData.constData() + position, length);
+}
+
+QString PageWrapper::between(const QString &start, const QString &end, int from) const
+{
+    const QByteArray startBytes = encode(start);
+    const int startIndex = mData.indexOf(startBytes, from);
+    if (startIndex == -1) {
+        return QString();
+    }
+
+    const int contentIndex = startIndex + startBytes.size();
+    const int endIndex = mData.indexOf(encode(end), contentIndex);
+    if (endIndex == -1) {
+        return QString();
+    }
+
+    return mid(contentIndex, endIndex - contentIndex);
+}
+
+QString PageWrapper::text() const
+{
+    if (mText.isNull() && !mData.isEmpty()) {
+        mText = codec()->toUnicode(mData);
+    }
+    return mText;
+}
+
 DateWrapper::DateWrapper(QObject *parent, const QDate &date)
     : QObject(parent)
     , mDate(date)
@@ -257,18 +349,26 @@ QString StaticDateWrapper::shortMonthName(int month)
     return QLocale::system().monthName(month, QLocale::ShortFormat);
 }
 
-ComicProviderWrapper::ComicProviderWrapper(ComicProviderKross *parent)
-    : QObject(parent)
+ComicProviderWrapper::ComicProviderWrapper(const ComicProviderKross *provider)
+    : QObject(nullptr)
     , mAction(nullptr)
-    , mProvider(parent)
     , mKrossImage(nullptr)
     , mPackage(nullptr)
+    , mDescription(provider->description())
+    , mPluginName(provider->pluginName())
+    , mRequestedDate(provider->requestedDate())
+    , mRequestedNumber(provider->requestedNumber())
+    , mRequestedString(provider->requestedString())
+    , mComicAuthor(provider->ComicProvider::comicAuthor())
     , mRequests(0)
     , mIdentifierSpecified(false)
     , mIsLeftToRight(true)
     , mIsTopToBottom(true)
+    , mPagesAsObjects(false)
 {
-    QTimer::singleShot(0, this, &ComicProviderWrapper::init);
+    setIdentifierToDefault();
+    // done here, in the thread of the engine, as neither KPackage nor Kross::Manager are thread safe
+    findScript();
 }
 
 ComicProviderWrapper::~ComicProviderWrapper()
@@ -276,12 +376,18 @@ ComicProviderWrapper::~ComicProviderWrapper()
     delete mPackage;
 }
 
-void ComicProviderWrapper::init()
+void ComicProviderWrapper::start(bool identifierSpecified)
+{
+    mIdentifierSpecified = identifierSpecified;
+    init();
+}
+
+void ComicProviderWrapper::findScript()
 {
     const QString path = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                                QLatin1String("plasma/comics/") + mProvider->pluginName() + QLatin1Char('/'),
+                                                QLatin1String("plasma/comics/") + mPluginName + QLatin1Char('/'),
                                                 QStandardPaths::LocateDirectory);
-    // qDebug() << "ComicProviderWrapper::init() package is" << mProvider->pluginName() << " at " <<  path;
+    // qDebug() << "ComicProviderWrapper::init() package is" << mPluginName << " at " <<  path;
 
     if (!path.isEmpty()) {
         mPackage = new KPackage::Package(ComicProviderKross::packageStructure());
@@ -302,24 +408,32 @@ void ComicProviderWrapper::init()
             }
 
             if (info.exists()) {
-                mAction = new Kross::Action(parent(), mProvider->pluginName());
-                if (mAction) {
-                    mAction->addObject(this, QLatin1String("comic"));
-                    mAction->addObject(new StaticDateWrapper(this), QLatin1String("date"));
-                    mAction->setFile(info.filePath());
-                    mAction->trigger();
-                    mFunctions = mAction->functionNames();
-
-                    mIdentifierSpecified = !mProvider->isCurrent();
-                    setIdentifierToDefault();
-                    callFunction(QLatin1String("init"));
-                }
+                mScriptPath = info.filePath();
+                // the manager creates and loads the interpreter on first use
+                Kross::Manager::self().interpreter(Kross::Manager::self().interpreternameForFile(mScriptPath));
             }
         }
     }
 }
 
-const QStringList &ComicProviderWrapper::extensions() const
+void ComicProviderWrapper::init()
+{
+    if (mScriptPath.isEmpty()) {
+        return;
+    }
+
+    mAction = new Kross::Action(this, mPluginName);
+    mAction->addObject(this, QLatin1String("comic"));
+    mAction->addObject(new StaticDateWrapper(this), QLatin1String("date"));
+    mAction->setFile(mScriptPath);
+    mAction->trigger();
+    mFunctions = mAction->functionNames();
+
+    setIdentifierToDefault();
+    callFunction(QLatin1String("init"));
+}
+
+const QStringList &ComicProviderWrapper::extensions()
 {
     if (mExtensions.isEmpty()) {
         Kross::InterpreterInfo *info;
@@ -340,7 +454,7 @@ const QStringList &ComicProviderWrapper::extensions() const
 ComicProvider::IdentifierType ComicProviderWrapper::identifierType() const
 {
     ComicProvider::IdentifierType result = ComicProvider::StringIdentifier;
-    const QString type = mProvider->description().value(QLatin1String("X-KDE-PlasmaComicProvider-SuffixType"));
+    const QString type = mDescription.value(QLatin1String("X-KDE-PlasmaComicProvider-SuffixType"));
     if (type == QLatin1String("Date")) {
         result = ComicProvider::DateIdentifier;
     } else if (type == QLatin1String("Number")) {
@@ -421,15 +535,15 @@ void ComicProviderWrapper::setIdentifierToDefault()
 {
     switch (identifierType()) {
     case DateIdentifier:
-        mIdentifier = mProvider->requestedDate();
+        mIdentifier = mRequestedDate;
         mLastIdentifier = QDate::currentDate();
         break;
     case NumberIdentifier:
-        mIdentifier = mProvider->requestedNumber();
+        mIdentifier = mRequestedNumber;
         mFirstIdentifier = 1;
         break;
     case StringIdentifier:
-        mIdentifier = mProvider->requestedString();
+        mIdentifier = mRequestedString;
         break;
     }
 }
@@ -459,6 +573,16 @@ void ComicProviderWrapper::setTopToBottom(bool ttb)
     mIsTopToBottom = ttb;
 }
 
+bool ComicProviderWrapper::pagesAsObjects() const
+{
+    return mPagesAsObjects;
+}
+
+void ComicProviderWrapper::setPagesAsObjects(bool pagesAsObjects)
+{
+    mPagesAsObjects = pagesAsObjects;
+}
+
 QString ComicProviderWrapper::textCodec() const
 {
     return QString::fromLatin1(mTextCodec);
@@ -471,12 +595,12 @@ void ComicProviderWrapper::setTextCodec(const QString &textCodec)
 
 QString ComicProviderWrapper::comicAuthor() const
 {
-    return mProvider->comicAuthor();
+    return mComicAuthor;
 }
 
 void ComicProviderWrapper::setComicAuthor(const QString &author)
 {
-    mProvider->setComicAuthor(author);
+    mComicAuthor = author;
 }
 
 QString ComicProviderWrapper::websiteUrl() const
@@ -565,16 +689,6 @@ QVariant ComicProviderWrapper::firstIdentifier()
 
 void ComicProviderWrapper::setFirstIdentifier(const QVariant &firstIdentifier)
 {
-    switch (identifierType()) {
-    case DateIdentifier:
-        mProvider->setFirstStripDate(DateWrapper::fromVariant(firstIdentifier));
-        break;
-    case NumberIdentifier:
-        mProvider->setFirstStripNumber(firstIdentifier.toInt());
-        break;
-    case StringIdentifier:
-        break;
-    }
     mFirstIdentifier = identifierFromScript(firstIdentifier);
     checkIdentifier(&mIdentifier);
 }
@@ -699,6 +813,10 @@ void ComicProviderWrapper::pageRetrieved(int id, const QByteArray &data)
         if (mRequests < 1) { // Don't finish if we still have pageRequests
             finished();
         }
+    } else if (mPagesAsObjects) {
+        PageWrapper *page = new PageWrapper(this, data, mTextCodec);
+        callFunction(QLatin1String("pageRetrieved"), QVariantList() << id << QVariant::fromValue(qobject_cast<QObject *>(page)));
+        page->deleteLater();
     } else {
         QTextCodec *codec = nullptr;
         if (!mTextCodec.isEmpty()) {
@@ -718,7 +836,7 @@ void ComicProviderWrapper::pageError(int id, const QString &message)
     --mRequests;
     callFunction(QLatin1String("pageError"), QVariantList() << id << message);
     if (!functionCalled()) {
-        Q_EMIT mProvider->error(mProvider);
+        error();
     }
 }
 
@@ -731,7 +849,27 @@ void ComicProviderWrapper::redirected(int id, const QUrl &newUrl)
     }
 }
 
-void ComicProviderWrapper::finished() const
+ComicScriptResult ComicProviderWrapper::result(bool withImage)
+{
+    ComicScriptResult result;
+    if (withImage) {
+        result.image = comicImage();
+    }
+    result.comicAuthor = mComicAuthor;
+    result.websiteUrl = mWebsiteUrl;
+    result.shopUrl = mShopUrl;
+    result.title = mTitle;
+    result.additionalText = mAdditionalText;
+    result.identifier = identifierVariant();
+    result.nextIdentifier = nextIdentifierVariant();
+    result.previousIdentifier = previousIdentifierVariant();
+    result.firstIdentifier = firstIdentifierVariant();
+    result.isLeftToRight = mIsLeftToRight;
+    result.isTopToBottom = mIsTopToBottom;
+    return result;
+}
+
+void ComicProviderWrapper::finished()
 {
     qDebug() << QString::fromLatin1("Author").leftJustified(22, QLatin1Char('.')) << comicAuthor();
     qDebug() << QString::fromLatin1("Website URL").leftJustified(22, QLatin1Char('.')) << mWebsiteUrl;
@@ -743,33 +881,24 @@ void ComicProviderWrapper::finished() const
     qDebug() << QString::fromLatin1("Last Identifier").leftJustified(22, QLatin1Char('.')) << mLastIdentifier;
     qDebug() << QString::fromLatin1("Next Identifier").leftJustified(22, QLatin1Char('.')) << mNextIdentifier;
     qDebug() << QString::fromLatin1("Previous Identifier").leftJustified(22, QLatin1Char('.')) << mPreviousIdentifier;
-    Q_EMIT mProvider->finished(mProvider);
+    Q_EMIT scriptFinished(result(true));
 }
 
-void ComicProviderWrapper::error() const
+void ComicProviderWrapper::error()
 {
-    Q_EMIT mProvider->error(mProvider);
+    Q_EMIT scriptError(result(false));
 }
 
 void ComicProviderWrapper::requestPage(const QString &url, int id, const QVariantMap &infos)
 {
-    QMap<QString, QString> map;
-
-    for (auto it = infos.begin(), end = infos.end(); it != end; ++it) {
-        map[it.key()] = it.value().toString();
-    }
-    mProvider->requestPage(QUrl(url), id, map);
+    // the transfer is done by the provider, in the thread of the engine
+    Q_EMIT pageRequested(QUrl(url), id, infos);
     ++mRequests;
 }
 
 void ComicProviderWrapper::requestRedirectedUrl(const QString &url, int id, const QVariantMap &infos)
 {
-    QMap<QString, QString> map;
-
-    for (auto it = infos.begin(), end = infos.end(); it != end; ++it) {
-        map[it.key()] = it.value().toString();
-    }
-    mProvider->requestRedirectedUrl(QUrl(url), id, map);
+    Q_EMIT redirectedUrlRequested(QUrl(url), id, infos);
     ++mRequests;
 }
 
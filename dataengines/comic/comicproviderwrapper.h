@@ -14,6 +14,11 @@
 #include <QByteArray>
 #include <QImage>
 #include <QImageReader>
+#include <QMetaType>
+#include <QUrl>
+#include <QVariant>
+
+class QTextCodec;
 
 namespace Kross
 {
@@ -25,6 +30,26 @@ class Package;
 }
 class ComicProviderKross;
 
+/**
+ * What a comic script has found out, handed from the thread running the
+ * script to the provider.
+ */
+struct ComicScriptResult {
+    QImage image;
+    QString comicAuthor;
+    QString websiteUrl;
+    QString shopUrl;
+    QString title;
+    QString additionalText;
+    QVariant identifier;
+    QVariant nextIdentifier;
+    QVariant previousIdentifier;
+    QVariant firstIdentifier;
+    bool isLeftToRight = true;
+    bool isTopToBottom = true;
+};
+Q_DECLARE_METATYPE(ComicScriptResult)
+
 class ImageWrapper : public QObject
 {
     Q_OBJECT
@@ -72,6 +97,72 @@ private:
     QImageReader mImageReader;
 };
 
+/**
+ * A page handed to the script, if it has set pagesAsObjects.
+ *
+ * The page keeps the bytes as they have been downloaded. Searching and
+ * slicing works on the bytes, and only the parts asked for are decoded, so
+ * scripts which only need a little of a big page do not pay for decoding all
+ * of it. Positions are byte offsets, and the strings searched for are
+ * encoded like the page.
+ *
+ * The page is only valid while pageRetrieved runs.
+ * @since 4700
+ */
+class PageWrapper : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int length READ length)
+    Q_PROPERTY(QByteArray rawData READ rawData)
+    Q_PROPERTY(QString textCodec READ textCodec)
+public:
+    PageWrapper(QObject *parent, const QByteArray &data, const QByteArray &textCodec);
+
+    int length() const;
+    QByteArray rawData() const;
+    QString textCodec() const;
+
+public Q_SLOTS:
+    /**
+     * Returns the position of @p text at or after @p from, or -1
+     */
+    int indexOf(const QString &text, int from = 0) const;
+
+    /**
+     * Returns the position of @p text at or before @p from, or -1;
+     * from the end of the page if @p from is -1
+     */
+    int lastIndexOf(const QString &text, int from = -1) const;
+
+    bool contains(const QString &text) const;
+
+    /**
+     * Returns @p length bytes from @p position on, decoded;
+     * up to the end of the page if @p length is -1
+     */
+    QString mid(int position, int length = -1) const;
+
+    /**
+     * Returns what is between the first @p start at or after @p from and
+     * the next @p end, decoded, or an empty string if either is missing
+     */
+    QString between(const QString &start, const QString &end, int from = 0) const;
+
+    /**
+     * Returns the whole page, decoded
+     */
+    QString text() const;
+
+private:
+    QTextCodec *codec() const;
+    QByteArray encode(const QString &text) const;
+
+    const QByteArray mData;
+    const QByteArray mTextCodecName;
+    mutable QTextCodec *mCodec = nullptr;
+    mutable QString mText;
+};
+
 class DateWrapper : public QObject
 {
     Q_OBJECT
@@ -136,6 +227,14 @@ public Q_SLOTS:
     QString shortMonthName(int month);
 };
 
+/**
+ * This class runs the script of a comic and is what the script sees as "comic".
+ *
+ * It lives in a thread of its own, so neither the script nor the decoding of
+ * the pages for it blocks the engine. Everything it needs from the provider
+ * is copied on construction, and requests and results are passed back to
+ * the provider through signals.
+ */
 class ComicProviderWrapper : public QObject
 {
     Q_OBJECT
@@ -154,6 +253,7 @@ class ComicProviderWrapper : public QObject
     Q_PROPERTY(bool isLeftToRight READ isLeftToRight WRITE setLeftToRight)
     Q_PROPERTY(bool isTopToBottom READ isTopToBottom WRITE setTopToBottom)
     Q_PROPERTY(int apiVersion READ apiVersion)
+    Q_PROPERTY(bool pagesAsObjects READ pagesAsObjects WRITE setPagesAsObjects)
 public:
     enum PositionType {
         Left = 0,
@@ -187,14 +287,28 @@ public:
     };
     Q_ENUM(RedirectedUrlType)
 
-    explicit ComicProviderWrapper(ComicProviderKross *parent);
+    explicit ComicProviderWrapper(const ComicProviderKross *provider);
     ~ComicProviderWrapper() override;
 
+    /**
+     * Loads and runs the script, to be called in the thread of the wrapper.
+     */
+    void start(bool identifierSpecified);
+
+    static const QStringList &extensions();
+
     int apiVersion() const
     {
-        return 4600;
+        return 4700;
     }
 
+    /**
+     * Whether pageRetrieved gets pages as PageWrapper instead of decoded text
+     * @since 4700
+     */
+    bool pagesAsObjects() const;
+    void setPagesAsObjects(bool pagesAsObjects);
+
     ComicProvider::IdentifierType identifierType() const;
     QImage comicImage();
     void pageRetrieved(int id, const QByteArray &data);
@@ -235,9 +349,15 @@ public:
     QVariant nextIdentifierVariant() const;
     QVariant previousIdentifierVariant() const;
 
+Q_SIGNALS:
+    void pageRequested(const QUrl &url, int id, const QVariantMap &infos);
+    void redirectedUrlRequested(const QUrl &url, int id, const QVariantMap &infos);
+    void scriptFinished(const ComicScriptResult &result);
+    void scriptError(const ComicScriptResult &result);
+
 public Q_SLOTS:
-    void finished() const;
-    void error() const;
+    void finished();
+    void error();
 
     void requestPage(const QString &url, int id, const QVariantMap &infos = QVariantMap());
     void requestRedirectedUrl(const QString &url, int id, const QVariantMap &infos = QVariantMap());
@@ -248,23 +368,33 @@ public Q_SLOTS:
 
 protected:
     QVariant callFunction(const QString &name, const QVariantList &args = QVariantList());
-    const QStringList &extensions() const;
     bool functionCalled() const;
+    ComicScriptResult result(bool withImage);
     QVariant identifierToScript(const QVariant &identifier);
     QVariant identifierFromScript(const QVariant &identifier) const;
     void setIdentifierToDefault();
     void checkIdentifier(QVariant *identifier);
 
 private:
+    void findScript();
+
     Kross::Action *mAction;
-    ComicProviderKross *mProvider;
     QStringList mFunctions;
     bool mFuncFound;
     ImageWrapper *mKrossImage;
     static QStringList mExtensions;
     KPackage::Package *mPackage;
+    QString mScriptPath;
+
+    // copied from the provider
+    KPluginMetaData mDescription;
+    QString mPluginName;
+    QDate mRequestedDate;
+    int mRequestedNumber;
+    QString mRequestedString;
 
     QByteArray mTextCodec;
+    QString mComicAuthor;
     QString mWebsiteUrl;
     QString mShopUrl;
     QString mTitle;
@@ -278,6 +408,7 @@ private:
     bool mIdentifierSpecified;
     bool mIsLeftToRight;
     bool mIsTopToBottom;
+    bool mPagesAsObjects;
 };
 
 #endif
@@ -8,18 +8,31 @@
 #include "apodprovider.h"
 
 #include <QDebug>
-#include <QRegExp>
 
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdhtmlscanner.h"
+#include "potdimagejob.h"
+
 ApodProvider::ApodProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
     const QUrl url(QStringLiteral("http://antwrp.gsfc.nasa.gov/apod/"));
 
-    KIO::StoredTransferJob *job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(job, &KIO::StoredTransferJob::finished, this, &ApodProvider::pageRequestFinished);
+    PotdHtmlScanJob *job = new PotdHtmlScanJob(
+        url,
+        [this](const PotdHtmlScanner::Tag &tag) {
+            // the picture is linked relative to the page
+            const QByteArray href = tag.attribute("href");
+            if (tag.name == "a" && href.startsWith("image/")) {
+                mImageUrl = QUrl(QLatin1String("http://antwrp.gsfc.nasa.gov/apod/") + QString::fromUtf8(href));
+            }
+            return mImageUrl.isEmpty();
+        },
+        this);
+    connect(job, &KJob::finished, this, &ApodProvider::pageRequestFinished);
+    job->start();
 }
 
 ApodProvider::~ApodProvider() = default;
@@ -29,38 +42,28 @@ QImage ApodProvider::image() const
     return mImage;
 }
 
-void ApodProvider::pageRequestFinished(KJob *_job)
+void ApodProvider::pageRequestFinished(KJob *job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
-    if (job->error()) {
+    if (job->error() || !mImageUrl.isValid()) {
         Q_EMIT error(this);
         return;
     }
 
-    const QString data = QString::fromUtf8(job->data());
-
-    const QString pattern = QStringLiteral("<a href=\"(image/.*)\"");
-    QRegExp exp(pattern);
-    exp.setMinimal(true);
-    if (exp.indexIn(data) != -1) {
-        const QString sub = exp.cap(1);
-        const QUrl url(QLatin1String("http://antwrp.gsfc.nasa.gov/apod/") + sub);
-        KIO::StoredTransferJob *imageJob = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-        connect(imageJob, &KIO::StoredTransferJob::finished, this, &ApodProvider::imageRequestFinished);
-    } else {
-        Q_EMIT error(this);
-    }
+    setRemoteUrl(mImageUrl);
+    PotdImageJob *imageJob = new PotdImageJob(mImageUrl, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &ApodProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 void ApodProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
 
-    mImage = QImage::fromData(job->data());
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -55,6 +55,7 @@ private:
 
 private:
     QImage mImage;
+    QUrl mImageUrl;
 };
 
 #endif
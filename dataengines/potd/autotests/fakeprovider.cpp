@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <QImage>
+#include <QUrl>
+
+#include <KPluginFactory>
+
+#include "potdimagejob.h"
+#include "potdprovider.h"
+
+/**
+ * This provider serves the pictures in the fixtures directory, so the engine
+ * can be tested and benchmarked without network access.
+ *
+ * Identifiers without a date get the largest picture, dated ones one of the
+ * pictures depending on the date.
+ */
+class FakeProvider : public PotdProvider
+{
+    Q_OBJECT
+
+public:
+    FakeProvider(QObject *parent, const QVariantList &args)
+        : PotdProvider(parent, args)
+    {
+        static const QStringList fixtures = {
+            QStringLiteral("picture-1.png"),
+            QStringLiteral("picture-2.png"),
+            QStringLiteral("picture-3.png"),
+        };
+
+        const QString fixture = isFixedDate() ? fixtures.at(date().toJulianDay() % fixtures.size()) : fixtures.last();
+
+        const QUrl url = QUrl::fromLocalFile(QStringLiteral(FIXTURES_DIR "/") + fixture);
+
+        // goes through the same download and decoding as the real providers
+        setRemoteUrl(url);
+        PotdImageJob *imageJob = new PotdImageJob(url, QSize(), this);
+        connect(imageJob, &KJob::finished, this, &FakeProvider::imageRequestFinished);
+        imageJob->start();
+    }
+
+    QImage image() const override
+    {
+        return mImage;
+    }
+
+private:
+    void imageRequestFinished(KJob *_job)
+    {
+        PotdImageJob *job = static_cast<PotdImageJob *>(_job);
+        if (job->error()) {
+            Q_EMIT error(this);
+            return;
+        }
+
+        mImage = job->image();
+        Q_EMIT finished(this);
+    }
+
+    QImage mImage;
+};
+
+K_PLUGIN_CLASS_WITH_JSON(FakeProvider, "fakeprovider.json")
+
+#include "fakeprovider.moc"
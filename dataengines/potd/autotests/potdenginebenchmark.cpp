@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <QCoreApplication>
+#include <QDate>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <Plasma/DataEngine>
+
+#include "cachedprovider.h"
+#include "potd.h"
+
+namespace
+{
+constexpr int s_timeout = 30000;
+// Number of dated pictures requested at the same time by the fan-out benchmark
+constexpr int s_fanOut = 8;
+
+// Resets the peak resident set size of the process, where the kernel supports it
+void resetPeakRss()
+{
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("5");
+    }
+}
+
+// Peak resident set size of the process in kB, or -1 if unknown
+qint64 peakRss()
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+}
+
+class DataReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    DataReceiver()
+    {
+        clock.start();
+    }
+
+    // milliseconds from the creation of the receiver to the first image of a source
+    QHash<QString, qint64> firstImage;
+    QHash<QString, Plasma::DataEngine::Data> data;
+    qint64 bytesDecoded = 0;
+    int updates = 0;
+    QElapsedTimer clock;
+
+public Q_SLOTS:
+    void dataUpdated(const QString &source, const Plasma::DataEngine::Data &sourceData)
+    {
+        ++updates;
+        data[source] = sourceData;
+
+        const QImage image = sourceData.value(QStringLiteral("Image")).value<QImage>();
+        if (!image.isNull()) {
+            bytesDecoded += image.sizeInBytes();
+        }
+
+        const bool hasPicture = !image.isNull() || !sourceData.value(QStringLiteral("Hash")).toString().isEmpty();
+        if (hasPicture && !firstImage.contains(source)) {
+            firstImage.insert(source, clock.elapsed());
+        }
+    }
+};
+
+class PotdEngineBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkColdStart();
+    void benchmarkWarmStart();
+    void benchmarkDayRollover();
+    void benchmarkFanOut();
+
+private:
+    void report(const char *scenario, qint64 latency, const DataReceiver &receiver);
+    bool waitUntilSettled(const DataReceiver &receiver);
+    void clearCache();
+};
+
+void PotdEngineBenchmark::initTestCase()
+{
+    // keep the cache of the user out of it, before the engine resolves its directories
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::addLibraryPath(QStringLiteral(PLUGIN_DIR));
+    clearCache();
+}
+
+void PotdEngineBenchmark::cleanupTestCase()
+{
+    clearCache();
+}
+
+void PotdEngineBenchmark::clearCache()
+{
+    QDir(CachedProvider::cacheDir()).removeRecursively();
+}
+
+void PotdEngineBenchmark::report(const char *scenario, qint64 latency, const DataReceiver &receiver)
+{
+    qInfo("%s: first image after %lld ms, %lld bytes decoded, peak RSS %lld kB",
+          scenario,
+          latency,
+          receiver.bytesDecoded,
+          peakRss());
+    QTest::setBenchmarkResult(latency, QTest::WalltimeMilliseconds);
+}
+
+bool PotdEngineBenchmark::waitUntilSettled(const DataReceiver &receiver)
+{
+    // the engine is done once a while passes without an update
+    QElapsedTimer timer;
+    timer.start();
+    int updates = -1;
+    while (timer.elapsed() < s_timeout) {
+        if (receiver.updates == updates) {
+            return true;
+        }
+        updates = receiver.updates;
+        QTest::qWait(500);
+    }
+    return false;
+}
+
+void PotdEngineBenchmark::benchmarkColdStart()
+{
+    clearCache();
+    resetPeakRss();
+
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    engine->connectSource(QStringLiteral("fake"), &receiver);
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.firstImage.contains(QStringLiteral("fake")), s_timeout);
+    report("cold start", receiver.firstImage.value(QStringLiteral("fake")), receiver);
+
+    QVERIFY(waitUntilSettled(receiver));
+    QVERIFY(QFile::exists(CachedProvider::identifierToPath(QStringLiteral("fake"))));
+}
+
+void PotdEngineBenchmark::benchmarkWarmStart()
+{
+    QVERIFY(QFile::exists(CachedProvider::identifierToPath(QStringLiteral("fake"))));
+    resetPeakRss();
+
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    engine->connectSource(QStringLiteral("fake"), &receiver);
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.firstImage.contains(QStringLiteral("fake")), s_timeout);
+    report("warm start", receiver.firstImage.value(QStringLiteral("fake")), receiver);
+
+    QVERIFY(waitUntilSettled(receiver));
+}
+
+void PotdEngineBenchmark::benchmarkDayRollover()
+{
+    const QString identifier = QStringLiteral("fake");
+    QVERIFY(QFile::exists(CachedProvider::identifierToPath(identifier)));
+
+    // a picture fetched ahead of time for today, found by the engine on start
+    QDir().mkpath(CachedProvider::stagingDir());
+    const QString staged = CachedProvider::stagingPath(identifier, QDate::currentDate());
+    QFile::remove(staged);
+    QVERIFY(QFile::copy(QStringLiteral(FIXTURES_DIR "/picture-1.png"), staged));
+
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    engine->connectSource(identifier, &receiver);
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.firstImage.contains(identifier), s_timeout);
+    QVERIFY(waitUntilSettled(receiver));
+
+    // the staged picture is shown when the day changes
+    resetPeakRss();
+    receiver.firstImage.clear();
+    receiver.bytesDecoded = 0;
+    receiver.clock.restart();
+    QVERIFY(QMetaObject::invokeMethod(engine.data(), "checkDayChanged"));
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.firstImage.contains(identifier), s_timeout);
+    report("day rollover", receiver.firstImage.value(identifier), receiver);
+
+    QVERIFY(!QFile::exists(staged));
+    QVERIFY(waitUntilSettled(receiver));
+}
+
+void PotdEngineBenchmark::benchmarkFanOut()
+{
+    QStringList sources;
+    const QDate first(2021, 1, 1);
+    for (int i = 0; i < s_fanOut; ++i) {
+        const QString identifier = QStringLiteral("fake:") + first.addDays(i).toString(Qt::ISODate);
+        QFile::remove(CachedProvider::identifierToPath(identifier));
+        sources << identifier << QStringLiteral("file:") + identifier;
+    }
+    resetPeakRss();
+
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    for (const QString &source : qAsConst(sources)) {
+        engine->connectSource(source, &receiver);
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.firstImage.size() == sources.size(), s_timeout);
+
+    qint64 latency = 0;
+    for (qint64 sourceLatency : qAsConst(receiver.firstImage)) {
+        latency = qMax(latency, sourceLatency);
+    }
+    report("fan-out", latency, receiver);
+
+    QVERIFY(waitUntilSettled(receiver));
+}
+
+QTEST_GUILESS_MAIN(PotdEngineBenchmark)
+
+#include "potdenginebenchmark.moc"
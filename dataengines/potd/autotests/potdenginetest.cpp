@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <Plasma/DataEngine>
+
+#include <time.h>
+
+#include "cachedprovider.h"
+#include "potd.h"
+#include "potdhistory.h"
+#include "potdioexecutor.h"
+
+namespace
+{
+constexpr int s_timeout = 30000;
+}
+
+class DataReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    QHash<QString, Plasma::DataEngine::Data> data;
+
+    bool hasImage(const QString &source) const
+    {
+        return !data.value(source).value(QStringLiteral("Image")).value<QImage>().isNull();
+    }
+
+public Q_SLOTS:
+    void dataUpdated(const QString &source, const Plasma::DataEngine::Data &sourceData)
+    {
+        data[source] = sourceData;
+    }
+};
+
+/**
+ * Tests fetching the next picture of a provider ahead of time, with the fake
+ * provider, which serves the same picture every day for identifiers without
+ * a date.
+ */
+class PotdEngineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void testStagingSamePicture();
+    void testStagingNewPicture();
+
+private:
+    void makeCacheOutdated();
+    void stage(PotdEngine *engine);
+    bool waitForIo();
+    QStringList historyFiles() const;
+};
+
+void PotdEngineTest::initTestCase()
+{
+    // The picture of the day is published at midnight UTC, and a cached picture is
+    // only current on the day it has been stored, in local time. Run an hour east of
+    // UTC, so there is a time of today, before the picture has been published, for
+    // the cached picture to be from.
+    qputenv("TZ", "XXX-1");
+    tzset();
+
+    const QTime now = QDateTime::currentDateTimeUtc().time();
+    if (now < QTime(0, 20) || now > QTime(22, 50)) {
+        QSKIP("The next picture is only fetched ahead of time between 00:15 and 23:00 UTC");
+    }
+
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::addLibraryPath(QStringLiteral(PLUGIN_DIR));
+}
+
+void PotdEngineTest::init()
+{
+    QDir(CachedProvider::cacheDir()).removeRecursively();
+}
+
+void PotdEngineTest::cleanupTestCase()
+{
+    QDir(CachedProvider::cacheDir()).removeRecursively();
+}
+
+bool PotdEngineTest::waitForIo()
+{
+    // anything a finished task leads to is queued right away
+    QTest::qWait(500);
+    QElapsedTimer timer;
+    timer.start();
+    while (!timer.hasExpired(s_timeout)) {
+        const PotdIoExecutor::Statistics statistics = PotdIoExecutor::self()->statistics();
+        if (statistics.queued == 0 && statistics.active == 0) {
+            return true;
+        }
+        QTest::qWait(100);
+    }
+    return false;
+}
+
+QStringList PotdEngineTest::historyFiles() const
+{
+    return QDir(PotdHistory::historyDir()).entryList(QDir::Files);
+}
+
+void PotdEngineTest::makeCacheOutdated()
+{
+    QVERIFY(QDir(PotdHistory::historyDir()).removeRecursively());
+
+    // stored shortly before the picture of today has been published
+    const QDateTime published(QDateTime::currentDateTimeUtc().date(), QTime(0, 0), Qt::UTC);
+    QFile file(CachedProvider::identifierToPath(QStringLiteral("fake")));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(published.addSecs(-60), QFileDevice::FileModificationTime));
+}
+
+void PotdEngineTest::stage(PotdEngine *engine)
+{
+    QSignalSpy tasks(PotdIoExecutor::self(), &PotdIoExecutor::taskFinished);
+
+    // the engine learns about the outdated picture from its directory watcher, until
+    // then it does not see anything to fetch
+    QElapsedTimer timer;
+    timer.start();
+    while (tasks.isEmpty() && !timer.hasExpired(s_timeout)) {
+        QVERIFY(QMetaObject::invokeMethod(engine, "checkDayChanged"));
+        tasks.wait(500);
+    }
+    QVERIFY2(!tasks.isEmpty(), "the next picture has not been fetched ahead of time");
+    QVERIFY(waitForIo());
+}
+
+void PotdEngineTest::testStagingSamePicture()
+{
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    engine->connectSource(QStringLiteral("fake"), &receiver);
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.hasImage(QStringLiteral("fake")), s_timeout);
+    QVERIFY(waitForIo());
+    // the picture fetched for the source is in the history
+    QVERIFY(!historyFiles().isEmpty());
+
+    makeCacheOutdated();
+    stage(engine.data());
+
+    // the provider still had the cached picture, which is not the one of today
+    QVERIFY(QDir(CachedProvider::stagingDir()).entryList(QDir::Files).isEmpty());
+    QVERIFY(historyFiles().isEmpty());
+}
+
+void PotdEngineTest::testStagingNewPicture()
+{
+    DataReceiver receiver;
+    QScopedPointer<PotdEngine> engine(new PotdEngine(nullptr, QVariantList()));
+    engine->connectSource(QStringLiteral("fake"), &receiver);
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.hasImage(QStringLiteral("fake")), s_timeout);
+    QVERIFY(waitForIo());
+
+    // the cached picture of yesterday was a different one
+    QVERIFY(QImage(QStringLiteral(FIXTURES_DIR "/picture-1.png")).save(CachedProvider::identifierToPath(QStringLiteral("fake")), "JPEG"));
+    makeCacheOutdated();
+    stage(engine.data());
+
+    // kept, and in the history of the day it has been published
+    const QDate published = QDateTime::currentDateTimeUtc().date();
+    QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(PotdHistory::monthPath(QStringLiteral("fake"), published)), s_timeout);
+}
+
+QTEST_GUILESS_MAIN(PotdEngineTest)
+
+#include "potdenginetest.moc"
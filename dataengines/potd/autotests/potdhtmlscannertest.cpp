@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <QTest>
+
+#include "potdhtmlscanner.h"
+
+class PotdHtmlScannerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAttributeValues();
+    void testCharacterReferences();
+    void testSkippedMarkup();
+    void testRawText();
+    void testSplitData_data();
+    void testSplitData();
+    void testStop();
+
+private:
+    static QVector<PotdHtmlScanner::Tag> scan(const QList<QByteArray> &pieces);
+};
+
+QVector<PotdHtmlScanner::Tag> PotdHtmlScannerTest::scan(const QList<QByteArray> &pieces)
+{
+    QVector<PotdHtmlScanner::Tag> tags;
+    PotdHtmlScanner scanner([&tags](const PotdHtmlScanner::Tag &tag) {
+        tags.append(tag);
+        return true;
+    });
+    for (const QByteArray &piece : pieces) {
+        scanner.addData(piece);
+    }
+    return tags;
+}
+
+void PotdHtmlScannerTest::testAttributeValues()
+{
+    const auto tags = scan({"<IMG Src=\"a b.jpg\" data-x='it\"s' width=10 hidden><br/>"});
+    QCOMPARE(tags.size(), 2);
+
+    const PotdHtmlScanner::Tag &img = tags.at(0);
+    QCOMPARE(img.name, QByteArray("img"));
+    QCOMPARE(img.attributes.size(), 4);
+    QCOMPARE(img.attribute("src"), QByteArray("a b.jpg"));
+    QCOMPARE(img.attribute("data-x"), QByteArray("it\"s"));
+    QCOMPARE(img.attribute("width"), QByteArray("10"));
+    // an attribute without a value is there, but empty
+    QCOMPARE(img.attributes.at(3).first, QByteArray("hidden"));
+    QVERIFY(img.attributes.at(3).second.isEmpty());
+    QVERIFY(img.attribute("alt").isNull());
+
+    QCOMPARE(tags.at(1).name, QByteArray("br"));
+    QVERIFY(tags.at(1).attributes.isEmpty());
+}
+
+void PotdHtmlScannerTest::testCharacterReferences()
+{
+    const auto tags = scan({"<a href=\"/p?a=1&amp;b=2&#38;c=&#x33;&nbsp;&\">"});
+    QCOMPARE(tags.size(), 1);
+    QCOMPARE(tags.at(0).attribute("href"), QByteArray("/p?a=1&b=2&c=3&nbsp;&"));
+}
+
+void PotdHtmlScannerTest::testSkippedMarkup()
+{
+    const auto tags = scan({"<!DOCTYPE html><!-- <img src=\"comment\"> -- still --><?xml x?></div>a < b<p>"});
+    QCOMPARE(tags.size(), 1);
+    QCOMPARE(tags.at(0).name, QByteArray("p"));
+}
+
+void PotdHtmlScannerTest::testRawText()
+{
+    const auto tags = scan({"<script>if (a </scri) { b = \"<img src='script'>\"; }</SCRIPT >"
+                            "<style>p { content: \"<img>\" }</style>"
+                            "<img src=\"after\">"});
+    QCOMPARE(tags.size(), 3);
+    QCOMPARE(tags.at(0).name, QByteArray("script"));
+    QCOMPARE(tags.at(1).name, QByteArray("style"));
+    QCOMPARE(tags.at(2).name, QByteArray("img"));
+    QCOMPARE(tags.at(2).attribute("src"), QByteArray("after"));
+}
+
+void PotdHtmlScannerTest::testSplitData_data()
+{
+    QTest::addColumn<QList<QByteArray>>("pieces");
+
+    QTest::newRow("end tag") << QList<QByteArray>{"<img src=\"a.jpg\" alt=x><script></scr", "ipt><p>"};
+    QTest::newRow("name") << QList<QByteArray>{"<im", "g src=\"a.jpg\" alt=x><script></script><p>"};
+    QTest::newRow("attribute") << QList<QByteArray>{"<img sr", "c=\"a.j", "pg\" al", "t=", "x", "><script></script><p>"};
+    QTest::newRow("raw text end") << QList<QByteArray>{"<img src=\"a.jpg\" alt=x><script><", "/scr", "ipt><p>"};
+    QTest::newRow("bytes") << [] {
+        QList<QByteArray> pieces;
+        const QByteArray page = "<img src=\"a.jpg\" alt=x><!-- c --><script></script><p>";
+        for (char c : page) {
+            pieces.append(QByteArray(1, c));
+        }
+        return pieces;
+    }();
+}
+
+void PotdHtmlScannerTest::testSplitData()
+{
+    QFETCH(QList<QByteArray>, pieces);
+
+    const auto tags = scan(pieces);
+    QCOMPARE(tags.size(), 3);
+    QCOMPARE(tags.at(0).name, QByteArray("img"));
+    QCOMPARE(tags.at(0).attribute("src"), QByteArray("a.jpg"));
+    QCOMPARE(tags.at(0).attribute("alt"), QByteArray("x"));
+    QCOMPARE(tags.at(1).name, QByteArray("script"));
+    QCOMPARE(tags.at(2).name, QByteArray("p"));
+}
+
+void PotdHtmlScannerTest::testStop()
+{
+    QVector<QByteArray> names;
+    PotdHtmlScanner scanner([&names](const PotdHtmlScanner::Tag &tag) {
+        names.append(tag.name);
+        return tag.name != "img";
+    });
+
+    QVERIFY(scanner.addData("<p><di"));
+    QVERIFY(!scanner.isStopped());
+    // the tags after the one the handler has stopped at are not reported
+    QVERIFY(!scanner.addData("v><img src=\"a.jpg\"><img src=\"b.jpg\"><p>"));
+    QVERIFY(scanner.isStopped());
+    QVERIFY(!scanner.addData("<span>"));
+
+    QCOMPARE(names, QVector<QByteArray>({"p", "div", "img"}));
+}
+
+QTEST_GUILESS_MAIN(PotdHtmlScannerTest)
+
+#include "potdhtmlscannertest.moc"
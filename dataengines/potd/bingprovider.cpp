@@ -13,6 +13,8 @@
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdimagejob.h"
+
 BingProvider::BingProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
@@ -55,8 +57,10 @@ void BingProvider::pageRequestFinished(KJob *_job)
             break;
         }
         QUrl picUrl(QStringLiteral("https://www.bing.com/%1").arg(url.toString()));
-        KIO::StoredTransferJob *imageJob = KIO::storedGet(picUrl, KIO::NoReload, KIO::HideProgressInfo);
-        connect(imageJob, &KIO::StoredTransferJob::finished, this, &BingProvider::imageRequestFinished);
+        setRemoteUrl(picUrl);
+        PotdImageJob *imageJob = new PotdImageJob(picUrl, QSize(), this);
+        connect(imageJob, &KJob::finished, this, &BingProvider::imageRequestFinished);
+        imageJob->start();
         return;
     } while (0);
 
@@ -66,13 +70,13 @@ void BingProvider::pageRequestFinished(KJob *_job)
 
 void BingProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
-    QByteArray data = job->data();
-    mImage = QImage::fromData(data);
+
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -6,19 +6,50 @@
 
 #include "cachedprovider.h"
 
-#include <QDateTime>
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
-#include <QRegularExpression>
+#include <QImageReader>
 #include <QStandardPaths>
-#include <QThreadPool>
 #include <QTimer>
 
 #include <QDebug>
 
-LoadImageThread::LoadImageThread(const QString &filePath)
-    : m_filePath(filePath)
+#include "potdioexecutor.h"
+
+namespace
+{
+// Width of the placeholders, they only need to give an idea of the picture
+constexpr int s_placeholderWidth = 32;
+
+// Placeholders are stale once the cached picture has been replaced
+bool needsPlaceholder(const QString &identifier, const QString &filePath)
+{
+    const QFileInfo placeholder(CachedProvider::placeholderPath(identifier));
+    return !placeholder.exists() || placeholder.lastModified() < QFileInfo(filePath).lastModified();
+}
+
+void savePlaceholder(const QString &identifier, const QImage &placeholder)
+{
+    if (placeholder.isNull()) {
+        return;
+    }
+
+    QDir().mkpath(CachedProvider::placeholderDir());
+    placeholder.save(CachedProvider::placeholderPath(identifier), "PNG");
+}
+
+QImage scaledPlaceholder(const QImage &image)
+{
+    return image.isNull() ? image : image.scaledToWidth(s_placeholderWidth, Qt::SmoothTransformation);
+}
+}
+
+LoadImageThread::LoadImageThread(const QString &identifier, const QString &filePath)
+    : m_identifier(identifier)
+    , m_filePath(filePath)
 {
 }
 
@@ -26,6 +57,12 @@ void LoadImageThread::run()
 {
     QImage image;
     image.load(m_filePath);
+
+    // pictures cached before placeholders existed, or promoted from staging
+    if (needsPlaceholder(m_identifier, m_filePath)) {
+        savePlaceholder(m_identifier, scaledPlaceholder(image));
+    }
+
     Q_EMIT done(image);
 }
 
@@ -39,24 +76,105 @@ void SaveImageThread::run()
 {
     const QString path = CachedProvider::identifierToPath(m_identifier);
     m_image.save(path, "JPEG");
+    savePlaceholder(m_identifier, scaledPlaceholder(m_image));
     Q_EMIT done(m_identifier, path, m_image);
 }
 
+ProbeImageThread::ProbeImageThread(const QString &identifier, const QString &filePath)
+    : m_identifier(identifier)
+    , m_filePath(filePath)
+{
+}
+
+void ProbeImageThread::run()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Q_EMIT done(m_identifier, m_filePath, QSize(), QByteArray());
+        return;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+
+    file.seek(0);
+    QImageReader reader(&file);
+    const QSize size = reader.size();
+
+    if (size.isValid() && needsPlaceholder(m_identifier, m_filePath)) {
+        // decoders like the JPEG one can scale while decoding, which is a lot cheaper
+        reader.setScaledSize(size.scaled(s_placeholderWidth, size.height(), Qt::KeepAspectRatio));
+        savePlaceholder(m_identifier, reader.read());
+    }
+
+    Q_EMIT done(m_identifier, m_filePath, size, hash.result());
+}
+
+StageImageThread::StageImageThread(const QString &identifier, const QImage &image, const QDate &date)
+    : m_image(image)
+    , m_identifier(identifier)
+    , m_date(date)
+{
+}
+
+void StageImageThread::run()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    m_image.save(&buffer, "JPEG");
+    buffer.close();
+
+    // The encoder is deterministic, so an unchanged picture gives the same bytes
+    QFile cached(CachedProvider::identifierToPath(m_identifier));
+    if (cached.open(QIODevice::ReadOnly) && cached.size() == data.size() && cached.readAll() == data) {
+        Q_EMIT done(m_identifier, QDate());
+        return;
+    }
+
+    QFile file(CachedProvider::stagingPath(m_identifier, m_date));
+    const bool staged = file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    Q_EMIT done(m_identifier, staged ? m_date : QDate());
+}
+
+QString CachedProvider::cacheDir()
+{
+    static const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/plasma_engine_potd/");
+    return dir;
+}
+
+QString CachedProvider::stagingDir()
+{
+    return cacheDir() + QLatin1String("staging/");
+}
+
+QString CachedProvider::placeholderDir()
+{
+    return cacheDir() + QLatin1String("placeholders/");
+}
+
+QString CachedProvider::placeholderPath(const QString &identifier)
+{
+    return placeholderDir() + identifier + QLatin1String(".png");
+}
+
 QString CachedProvider::identifierToPath(const QString &identifier)
 {
-    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/plasma_engine_potd/");
-    QDir d;
-    d.mkpath(dataDir);
-    return dataDir + identifier;
+    return cacheDir() + identifier;
+}
+
+QString CachedProvider::stagingPath(const QString &identifier, const QDate &date)
+{
+    return stagingDir() + identifier + QLatin1Char('@') + date.toString(Qt::ISODate);
 }
 
 CachedProvider::CachedProvider(const QString &identifier, QObject *parent)
     : PotdProvider(parent)
     , mIdentifier(identifier)
 {
-    LoadImageThread *thread = new LoadImageThread(identifierToPath(mIdentifier));
+    LoadImageThread *thread = new LoadImageThread(mIdentifier, identifierToPath(mIdentifier));
     connect(thread, &LoadImageThread::done, this, &CachedProvider::triggerFinished);
-    QThreadPool::globalInstance()->start(thread);
+    PotdIoExecutor::self()->start(thread, PotdIoExecutor::VisiblePriority, mIdentifier);
 }
 
 CachedProvider::~CachedProvider()
@@ -78,23 +196,3 @@ void CachedProvider::triggerFinished(const QImage &image)
     mImage = image;
     Q_EMIT finished(this);
 }
-
-bool CachedProvider::isCached(const QString &identifier, bool ignoreAge)
-{
-    const QString path = identifierToPath(identifier);
-    if (!QFile::exists(path)) {
-        return false;
-    }
-
-    QRegularExpression re(QLatin1String(":\\d{4}-\\d{2}-\\d{2}"));
-
-    if (!ignoreAge && !re.match(identifier).hasMatch()) {
-        // no date in the identifier, so it's a daily; check to see ifthe modification time is today
-        QFileInfo info(path);
-        if (info.lastModified().daysTo(QDateTime::currentDateTime()) >= 1) {
-            return false;
-        }
-    }
-
-    return true;
-}
@@ -7,6 +7,7 @@
 #ifndef CACHEDPROVIDER_H
 #define CACHEDPROVIDER_H
 
+#include <QDate>
 #include <QImage>
 #include <QRunnable>
 
@@ -47,15 +48,37 @@ public:
     QString identifier() const override;
 
     /**
-     * Returns whether a picture with the given @p identifier is cached.
+     * Returns the directory pictures are cached in
      */
-    static bool isCached(const QString &identifier, bool ignoreAge = false);
+    static QString cacheDir();
+
+    /**
+     * Returns the directory pictures fetched ahead of time are kept in
+     */
+    static QString stagingDir();
 
     /**
      * Returns a path for the given identifier
      */
     static QString identifierToPath(const QString &identifier);
 
+    /**
+     * Returns the path of the staged picture for the given identifier,
+     * which is meant to be shown from @p date on.
+     */
+    static QString stagingPath(const QString &identifier, const QDate &date);
+
+    /**
+     * Returns the directory the placeholders of the cached pictures are kept in
+     */
+    static QString placeholderDir();
+
+    /**
+     * Returns the path of the tiny version of the cached picture for the
+     * given identifier, which can be shown until the picture has been loaded.
+     */
+    static QString placeholderPath(const QString &identifier);
+
 private Q_SLOTS:
     void triggerFinished(const QImage &image);
 
@@ -69,13 +92,14 @@ class LoadImageThread : public QObject, public QRunnable
     Q_OBJECT
 
 public:
-    explicit LoadImageThread(const QString &filePath);
+    LoadImageThread(const QString &identifier, const QString &filePath);
     void run() override;
 
 Q_SIGNALS:
     void done(const QImage &pixmap);
 
 private:
+    QString m_identifier;
     QString m_filePath;
 };
 
@@ -95,4 +119,51 @@ private:
     QString m_identifier;
 };
 
+/**
+ * Reads the dimensions and a hash of the content of a cached picture,
+ * without decoding it. Only if the picture has no placeholder yet it is
+ * decoded, at the size of the placeholder.
+ */
+class ProbeImageThread : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    ProbeImageThread(const QString &identifier, const QString &filePath);
+    void run() override;
+
+Q_SIGNALS:
+    void done(const QString &identifier, const QString &path, const QSize &size, const QByteArray &hash);
+
+private:
+    QString m_identifier;
+    QString m_filePath;
+};
+
+/**
+ * Stores a picture which is meant to replace the cached one on @p date.
+ * Nothing is stored if the picture is the same as the cached one, which
+ * happens if the provider has not published its next picture yet.
+ */
+class StageImageThread : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    StageImageThread(const QString &identifier, const QImage &image, const QDate &date);
+    void run() override;
+
+Q_SIGNALS:
+    /**
+     * @p date is the date the picture has been staged for, or invalid if
+     * nothing has been staged.
+     */
+    void done(const QString &source, const QDate &date);
+
+private:
+    QImage m_image;
+    QString m_identifier;
+    QDate m_date;
+};
+
 #endif
@@ -8,18 +8,32 @@
 #include "epodprovider.h"
 
 #include <QDebug>
-#include <QRegExp>
 
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdhtmlscanner.h"
+#include "potdimagejob.h"
+
 EpodProvider::EpodProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
     const QUrl url(QStringLiteral("https://epod.usra.edu/blog/"));
 
-    KIO::StoredTransferJob *job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(job, &KIO::StoredTransferJob::finished, this, &EpodProvider::pageRequestFinished);
+    PotdHtmlScanJob *job = new PotdHtmlScanJob(
+        url,
+        [this](const PotdHtmlScanner::Tag &tag) {
+            // the first full size picture on the blog, like https://epod.usra.edu/.a/6a0105371bb32c970b0240a4f7e8bc200b-pi
+            const QByteArray link = tag.name == "img" ? tag.attribute("src") : tag.attribute("href");
+            const int start = link.indexOf("://epod.usra.edu/.a/");
+            if (start >= 0 && link.endsWith("-pi")) {
+                mImageUrl = QUrl(QLatin1String("https") + QString::fromUtf8(link.mid(start)));
+            }
+            return mImageUrl.isEmpty();
+        },
+        this);
+    connect(job, &KJob::finished, this, &EpodProvider::pageRequestFinished);
+    job->start();
 }
 
 EpodProvider::~EpodProvider() = default;
@@ -29,37 +43,28 @@ QImage EpodProvider::image() const
     return mImage;
 }
 
-void EpodProvider::pageRequestFinished(KJob *_job)
+void EpodProvider::pageRequestFinished(KJob *job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
-    if (job->error()) {
+    if (job->error() || !mImageUrl.isValid()) {
         Q_EMIT error(this);
         return;
     }
 
-    const QString data = QString::fromUtf8(job->data());
-
-    const QString pattern = QStringLiteral("://epod.usra.edu/.a/*-pi");
-    QRegExp exp(pattern);
-    exp.setPatternSyntax(QRegExp::Wildcard);
-
-    int pos = exp.indexIn(data) + pattern.length();
-    const QString sub = data.mid(pos - 4, pattern.length() + 10);
-    const QUrl url(QStringLiteral("https://epod.usra.edu/.a/%1-pi").arg(sub));
-    KIO::StoredTransferJob *imageJob = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(imageJob, &KIO::StoredTransferJob::finished, this, &EpodProvider::imageRequestFinished);
+    setRemoteUrl(mImageUrl);
+    PotdImageJob *imageJob = new PotdImageJob(mImageUrl, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &EpodProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 void EpodProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
 
-    // FIXME: this really should be done in a thread as this can block
-    mImage = QImage::fromData(job->data());
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -51,6 +51,7 @@ private:
 
 private:
     QImage mImage;
+    QUrl mImageUrl;
 };
 
 #endif
@@ -8,13 +8,19 @@
 #include "flickrprovider.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QRandomGenerator>
-#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QUrlQuery>
 
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdimagejob.h"
+
 static QUrl buildUrl(const QDate &date, const QString apiKey)
 {
     QUrl url(QLatin1String("https://api.flickr.com/services/rest/"));
@@ -29,9 +35,67 @@ static QUrl buildUrl(const QDate &date, const QString apiKey)
     return url;
 }
 
+static QString photoListDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/plasma_engine_potd/flickr/");
+}
+
+// The interestingness list of a given date never changes, so it is kept
+// to pick other pictures of that date without asking the API again.
+static QStringList readPhotoList(const QDate &date)
+{
+    QFile file(photoListDir() + date.toString(Qt::ISODate));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QStringList();
+    }
+
+    QStringList photoList;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (!line.isEmpty()) {
+            photoList.append(QString::fromUtf8(line));
+        }
+    }
+    return photoList;
+}
+
+static void writePhotoList(const QDate &date, const QStringList &photoList)
+{
+    const QString dir = photoListDir();
+    QDir().mkpath(dir);
+
+    QSaveFile file(dir + date.toString(Qt::ISODate));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    for (const QString &url : photoList) {
+        file.write(url.toUtf8());
+        file.write("\n");
+    }
+    file.commit();
+
+    // lists which have not been fetched for a while are unlikely to be needed again,
+    // whatever the date they are for; history and prefetching ask for old dates too
+    const QDateTime oldest = QDateTime::currentDateTime().addDays(-31);
+    const QFileInfoList lists = QDir(dir).entryInfoList(QDir::Files);
+    for (const QFileInfo &list : lists) {
+        if (list.lastModified() < oldest) {
+            QFile::remove(list.filePath());
+        }
+    }
+}
+
 FlickrProvider::FlickrProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
+    mActualDate = date().addDays(-2);
+
+    m_photoList = readPhotoList(mActualDate);
+    if (!m_photoList.isEmpty()) {
+        fetchRandomPhoto();
+        return;
+    }
+
     connect(this, &PotdProvider::configLoaded, this, &FlickrProvider::sendXmlRequest);
 
     loadConfig();
@@ -53,30 +117,28 @@ void FlickrProvider::sendXmlRequest(QString apiKey, QString apiSecret)
     }
 
     mApiKey = apiKey;
-    mActualDate = date().addDays(-2);
 
     const QUrl xmlUrl = buildUrl(mActualDate, apiKey);
 
-    KIO::StoredTransferJob *xmlJob = KIO::storedGet(xmlUrl, KIO::NoReload, KIO::HideProgressInfo);
-    connect(xmlJob, &KIO::StoredTransferJob::finished, this, &FlickrProvider::xmlRequestFinished);
+    // Clear the list
+    m_photoList.clear();
+    mStatusOk = true;
+    xml.clear();
+
+    KIO::TransferJob *xmlJob = KIO::get(xmlUrl, KIO::NoReload, KIO::HideProgressInfo);
+    connect(xmlJob, &KIO::TransferJob::data, this, &FlickrProvider::xmlDataReceived);
+    connect(xmlJob, &KIO::TransferJob::finished, this, &FlickrProvider::xmlRequestFinished);
 }
 
-void FlickrProvider::xmlRequestFinished(KJob *_job)
+void FlickrProvider::xmlDataReceived(KIO::Job *job, const QByteArray &data)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
-    if (job->error()) {
-        Q_EMIT error(this);
-        qDebug() << "xmlRequestFinished error";
-        refreshConfig();
+    Q_UNUSED(job);
+    if (!mStatusOk) {
         return;
     }
 
-    const QString data = QString::fromUtf8(job->data());
-
-    // Clear the list
-    m_photoList.clear();
-
-    xml.clear();
+    // The reader takes the bytes as they come, and reports a premature end
+    // of the document until the rest has arrived.
     xml.addData(data);
 
     while (!xml.atEnd()) {
@@ -86,13 +148,12 @@ void FlickrProvider::xmlRequestFinished(KJob *_job)
             auto attributes = xml.attributes();
             if (xml.name() == QLatin1String("rsp")) {
                 /* no pictures available for the specified parameters */
-                if (attributes.value(QLatin1String("stat")).toString() != QLatin1String("ok")) {
-                    Q_EMIT error(this);
-                    qDebug() << "xmlRequestFinished error: no photos for the query";
+                if (attributes.value(QLatin1String("stat")) != QLatin1String("ok")) {
+                    mStatusOk = false;
                     return;
                 }
             } else if (xml.name() == QLatin1String("photo")) {
-                if (attributes.value(QLatin1String("ispublic")).toString() != QLatin1String("1")) {
+                if (attributes.value(QLatin1String("ispublic")) != QLatin1String("1")) {
                     continue;
                 }
 
@@ -121,29 +182,55 @@ void FlickrProvider::xmlRequestFinished(KJob *_job)
             }
         }
     }
+}
+
+void FlickrProvider::xmlRequestFinished(KJob *job)
+{
+    if (job->error()) {
+        Q_EMIT error(this);
+        qDebug() << "xmlRequestFinished error";
+        refreshConfig();
+        return;
+    }
+
+    if (!mStatusOk) {
+        Q_EMIT error(this);
+        qDebug() << "xmlRequestFinished error: no photos for the query";
+        return;
+    }
 
     if (xml.error() && xml.error() != QXmlStreamReader::PrematureEndOfDocumentError) {
         qWarning() << "XML ERROR:" << xml.lineNumber() << ": " << xml.errorString();
     }
 
-    if (m_photoList.begin() != m_photoList.end()) {
-        QUrl url(m_photoList.at(QRandomGenerator::global()->bounded(m_photoList.size())));
-        KIO::StoredTransferJob *imageJob = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-        connect(imageJob, &KIO::StoredTransferJob::finished, this, &FlickrProvider::imageRequestFinished);
-    } else {
+    if (m_photoList.isEmpty()) {
         qDebug() << "empty list";
+        Q_EMIT error(this);
+        return;
     }
+
+    writePhotoList(mActualDate, m_photoList);
+    fetchRandomPhoto();
+}
+
+void FlickrProvider::fetchRandomPhoto()
+{
+    QUrl url(m_photoList.at(QRandomGenerator::global()->bounded(m_photoList.size())));
+    setRemoteUrl(url);
+    PotdImageJob *imageJob = new PotdImageJob(url, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &FlickrProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 void FlickrProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
 
-    mImage = QImage::fromData(job->data());
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -50,7 +50,9 @@ public:
 
 private:
     void sendXmlRequest(QString apiKey, QString apiSecret);
+    void xmlDataReceived(KIO::Job *job, const QByteArray &data);
     void xmlRequestFinished(KJob *job);
+    void fetchRandomPhoto();
     void imageRequestFinished(KJob *job);
 
 private:
@@ -61,6 +63,7 @@ private:
     QXmlStreamReader xml;
 
     int mFailureNumber = 0;
+    bool mStatusOk = true;
 
     QStringList m_photoList;
 };
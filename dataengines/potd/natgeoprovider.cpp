@@ -13,13 +13,25 @@
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdhtmlscanner.h"
+#include "potdimagejob.h"
+
 NatGeoProvider::NatGeoProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
     const QUrl url(QStringLiteral("https://www.nationalgeographic.com/photography/photo-of-the-day/"));
 
-    KIO::StoredTransferJob *job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(job, &KIO::StoredTransferJob::finished, this, &NatGeoProvider::pageRequestFinished);
+    PotdHtmlScanJob *job = new PotdHtmlScanJob(
+        url,
+        [this](const PotdHtmlScanner::Tag &tag) {
+            if (tag.name == "meta" && tag.attribute("property") == "og:image") {
+                mImageUrl = QUrl(QString::fromUtf8(tag.attribute("content")));
+            }
+            return mImageUrl.isEmpty();
+        },
+        this);
+    connect(job, &KJob::finished, this, &NatGeoProvider::pageRequestFinished);
+    job->start();
 }
 
 NatGeoProvider::~NatGeoProvider() = default;
@@ -29,46 +41,28 @@ QImage NatGeoProvider::image() const
     return mImage;
 }
 
-void NatGeoProvider::pageRequestFinished(KJob *_job)
+void NatGeoProvider::pageRequestFinished(KJob *job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
-    if (job->error()) {
-        Q_EMIT error(this);
-        return;
-    }
-
-    const QString data = QString::fromUtf8(job->data());
-    const QStringList lines = data.split(QLatin1Char('\n'));
-
-    QString url;
-
-    re.setPattern(QStringLiteral("<meta\\s+(?:\\S+=[\"']?(?:.(?![\"']?\\s+(?:\\S+)=|\\s*/?[>\"']))+.[\"']?\\s*)*property=\"og:image\"\\s*(?:\\S+=[\"']?(?:.(?![\"']?\\s+(?:\\S+)=|\\s*/?[>\"']))+.[\"']?\\s*)*content=[\"']?((?:.(?![\"']?\\s+(?:\\S+)=|\\s*/?[>\"']))+.)[\"']?\\s*(?:\\S+=[\"']?(?:.(?![\"']?\\s+(?:\\S+)=|\\s*/?[>\"']))+.[\"']?\\s*)*/>"));
-
-    for (int i = 0; i < lines.size(); i++) {
-        QRegularExpressionMatch match = re.match(lines.at(i));
-        if (match.hasMatch()) {
-            url = match.captured(1);
-        }
-    }
-
-    if (url.isEmpty()) {
+    if (job->error() || !mImageUrl.isValid()) {
         Q_EMIT error(this);
         return;
     }
 
-    KIO::StoredTransferJob *imageJob = KIO::storedGet(QUrl(url), KIO::NoReload, KIO::HideProgressInfo);
-    connect(imageJob, &KIO::StoredTransferJob::finished, this, &NatGeoProvider::imageRequestFinished);
+    setRemoteUrl(mImageUrl);
+    PotdImageJob *imageJob = new PotdImageJob(mImageUrl, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &NatGeoProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 void NatGeoProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
 
-    mImage = QImage::fromData(job->data());
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
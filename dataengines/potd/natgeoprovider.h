@@ -12,7 +12,6 @@
 #include "potdprovider.h"
 // Qt
 #include <QImage>
-#include <QRegularExpression>
 
 class KJob;
 
@@ -52,8 +51,7 @@ private:
 
 private:
     QImage mImage;
-
-    QRegularExpression re;
+    QUrl mImageUrl;
 };
 
 #endif
@@ -8,18 +8,35 @@
 #include "noaaprovider.h"
 
 #include <QDebug>
-#include <QRegularExpression>
 
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdhtmlscanner.h"
+#include "potdimagejob.h"
+
 NOAAProvider::NOAAProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
     const QUrl url(QStringLiteral("https://www.nesdis.noaa.gov/content/imagery-and-data"));
 
-    KIO::StoredTransferJob *job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(job, &KIO::StoredTransferJob::finished, this, &NOAAProvider::pageRequestFinished);
+    // The NOAA page is not valid XML, so scan its tags for the first picture
+    // which has been uploaded to the site, in any attribute.
+    PotdHtmlScanJob *job = new PotdHtmlScanJob(
+        url,
+        [this](const PotdHtmlScanner::Tag &tag) {
+            for (const auto &attribute : tag.attributes) {
+                const QByteArray &value = attribute.second;
+                if (value.startsWith("/sites/default/files/") && value.endsWith(".jpg")) {
+                    mImageUrl = QUrl(QStringLiteral("https://www.nesdis.noaa.gov") + QString::fromUtf8(value));
+                    return false;
+                }
+            }
+            return true;
+        },
+        this);
+    connect(job, &KJob::finished, this, &NOAAProvider::pageRequestFinished);
+    job->start();
 }
 
 NOAAProvider::~NOAAProvider() = default;
@@ -29,45 +46,28 @@ QImage NOAAProvider::image() const
     return mImage;
 }
 
-void NOAAProvider::pageRequestFinished(KJob *_job)
+void NOAAProvider::pageRequestFinished(KJob *job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
-    if (job->error()) {
-        Q_EMIT error(this);
-        return;
-    }
-
-    const QString data = QString::fromUtf8(job->data());
-
-    // Using regular expression could be fragile in such case, but the HTML
-    // NOAA page itself is not a valid XML file and unfortunately it could
-    // not be parsed successfully till the content we want. And we do not want
-    // to use heavy weight QtWebkit. So we use QRegularExpression to capture
-    // the wanted url here.
-    QUrl url;
-    QRegularExpression re(QStringLiteral("\"(/sites/default/files/.*\\.jpg)\""));
-    auto result = re.match(data);
-    if (result.hasMatch()) {
-        url = QUrl(QStringLiteral("https://www.nesdis.noaa.gov") + result.captured(1));
-    }
-    if (!url.isValid()) {
+    if (job->error() || !mImageUrl.isValid()) {
         Q_EMIT error(this);
         return;
     }
 
-    KIO::StoredTransferJob *imageJob = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(imageJob, &KIO::StoredTransferJob::finished, this, &NOAAProvider::imageRequestFinished);
+    setRemoteUrl(mImageUrl);
+    PotdImageJob *imageJob = new PotdImageJob(mImageUrl, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &NOAAProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 void NOAAProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
 
-    mImage = QImage::fromData(job->data());
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -52,6 +52,7 @@ private:
 
 private:
     QImage mImage;
+    QUrl mImageUrl;
 };
 
 #endif
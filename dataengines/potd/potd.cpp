@@ -7,21 +7,35 @@
 #include "potd.h"
 
 #include <QDate>
+#include <QDateTime>
 #include <QDebug>
-#include <QFile>
 #include <QFileInfo>
-#include <QRegularExpression>
-#include <QThreadPool>
 #include <QTimer>
+#include <QUrl>
 
+#include <KPluginFactory>
 #include <KPluginLoader>
 #include <KPluginMetaData>
 #include <Plasma/DataContainer>
 
 #include "cachedprovider.h"
+#include "potdcacheindex.h"
+#include "potdhistory.h"
+#include "potdioexecutor.h"
+#include "potdplugincache.h"
+#include "potdservice.h"
 
 namespace
 {
+// Number of pictures prefetch() downloads at the same time
+constexpr int s_maxPrefetchJobs = 2;
+// Largest range of dates prefetch() accepts
+constexpr int s_maxPrefetchDays = 366;
+// Time given to a provider to publish its picture before fetching it ahead of time
+constexpr int s_publishMarginSecs = 15 * 60;
+// Time to wait before trying again if the next picture had not been published yet
+constexpr int s_stagingRetrySecs = 60 * 60;
+
 namespace DataKeys
 {
 inline QString image()
@@ -32,6 +46,104 @@ inline QString url()
 {
     return QStringLiteral("Url");
 }
+inline QString source()
+{
+    return QStringLiteral("Source");
+}
+inline QString width()
+{
+    return QStringLiteral("Width");
+}
+inline QString height()
+{
+    return QStringLiteral("Height");
+}
+inline QString hash()
+{
+    return QStringLiteral("Hash");
+}
+inline QString placeholder()
+{
+    return QStringLiteral("Placeholder");
+}
+inline QString queued()
+{
+    return QStringLiteral("Queued");
+}
+inline QString active()
+{
+    return QStringLiteral("Active");
+}
+inline QString lastLatency()
+{
+    return QStringLiteral("LastLatency");
+}
+inline QString averageLatency()
+{
+    return QStringLiteral("AverageLatency");
+}
+}
+
+// Source with the state of the file and decoding work
+inline QLatin1String ioSource()
+{
+    return QLatin1String("IO");
+}
+
+// Sources with this prefix get the cached file instead of the decoded image
+inline QLatin1String filePrefix()
+{
+    return QLatin1String("file:");
+}
+
+inline bool isFileSource(const QString &source)
+{
+    return source.startsWith(filePrefix());
+}
+
+inline QString sourceIdentifier(const QString &source)
+{
+    return isFileSource(source) ? source.mid(filePrefix().size()) : source;
+}
+
+inline QString fileSource(const QString &identifier)
+{
+    return filePrefix() + identifier;
+}
+
+// Sources with this prefix get the history of a provider for a month, e.g. history:apod:2021-07
+inline QLatin1String historyPrefix()
+{
+    return QLatin1String("history:");
+}
+
+inline bool isHistorySource(const QString &source)
+{
+    return source.startsWith(historyPrefix());
+}
+
+inline QString historySource(const QString &provider, const QDate &date)
+{
+    return historyPrefix() + provider + QLatin1Char(':') + date.toString(QStringLiteral("yyyy-MM"));
+}
+
+QDateTime lastPublishTime(const KPluginMetaData &metadata, const QDateTime &now)
+{
+    QTime time = QTime::fromString(metadata.value(QStringLiteral("X-KDE-PlasmaPoTDProvider-PublishTime")), QStringLiteral("HH:mm"));
+    if (!time.isValid()) {
+        time = QTime(0, 0);
+    }
+
+    QDateTime published(now.toUTC().date(), time, Qt::UTC);
+    if (published > now) {
+        published = published.addDays(-1);
+    }
+    return published;
+}
+
+bool isDated(const KPluginMetaData &metadata)
+{
+    return metadata.value(QStringLiteral("X-KDE-PlasmaPoTDProvider-Dated")) == QLatin1String("true");
 }
 }
 
@@ -40,6 +152,8 @@ PotdEngine::PotdEngine(QObject *parent, const QVariantList &args)
 {
     // set polling to every 5 minutes
     setMinimumPollingInterval(5 * 60 * 1000);
+    m_cacheIndex = new PotdCacheIndex(this);
+
     m_checkDatesTimer = new QTimer(this); // change picture after 24 hours
     connect(m_checkDatesTimer, &QTimer::timeout, this, &PotdEngine::checkDayChanged);
     // FIXME: would be nice to stop and start this timer ONLY as needed, e.g. only when there are
@@ -48,9 +162,16 @@ PotdEngine::PotdEngine(QObject *parent, const QVariantList &args)
     m_checkDatesTimer->setInterval(10 * 60 * 1000); // check every 10 minutes
     m_checkDatesTimer->start();
 
-    const QVector<KPluginMetaData> plugins = KPluginLoader::findPlugins(QStringLiteral("potd"), [](const KPluginMetaData &md) {
-        return md.serviceTypes().contains(QStringLiteral("PlasmaPoTD/Plugin"));
+    // promote pictures fetched ahead of time as soon as the day they are meant for starts
+    m_dayBoundaryTimer = new QTimer(this);
+    m_dayBoundaryTimer->setSingleShot(true);
+    connect(m_dayBoundaryTimer, &QTimer::timeout, this, [this] {
+        checkDayChanged();
+        scheduleDayBoundary();
     });
+    scheduleDayBoundary();
+
+    const QVector<KPluginMetaData> plugins = PotdPluginCache::findPlugins();
 
     for (const auto &metadata : plugins) {
         QString provider = metadata.value(QLatin1String("X-KDE-PlasmaPoTDProvider-Identifier"));
@@ -60,27 +181,51 @@ PotdEngine::PotdEngine(QObject *parent, const QVariantList &args)
         mFactories.insert(provider, metadata);
         setData(QLatin1String("Providers"), provider, metadata.name());
     }
+
+    // loads nobody waits for anymore do not need to hold up the others
+    connect(this, &Plasma::DataEngine::sourceRemoved, this, &PotdEngine::dropPendingLoads);
+    // the statistics are only kept current while somebody is connected to them
+    connect(PotdIoExecutor::self(), &PotdIoExecutor::taskFinished, this, [this]() {
+        if (containerForSource(ioSource())) {
+            publishIoStatistics();
+        }
+    });
 }
 
 PotdEngine::~PotdEngine()
 {
 }
 
-bool PotdEngine::updateSourceEvent(const QString &identifier)
+bool PotdEngine::updateSourceEvent(const QString &source)
 {
-    return updateSource(identifier, false);
+    if (source == ioSource()) {
+        publishIoStatistics();
+        return true;
+    }
+
+    return updateSource(source, false);
 }
 
-bool PotdEngine::updateSource(const QString &identifier, bool loadCachedAlways)
+bool PotdEngine::updateSource(const QString &source, bool loadCachedAlways)
 {
+    if (isHistorySource(source)) {
+        return loadHistory(source);
+    }
+
+    const QString identifier = sourceIdentifier(source);
+
     // check whether it is cached already...
-    if (CachedProvider::isCached(identifier, loadCachedAlways)) {
-        QVariantList args;
-        args << QLatin1String("String") << identifier;
+    if (m_cacheIndex->isCached(identifier, loadCachedAlways)) {
+        publishPlaceholder(source);
 
-        CachedProvider *provider = new CachedProvider(identifier, this);
-        connect(provider, &PotdProvider::finished, this, &PotdEngine::finished);
-        connect(provider, &PotdProvider::error, this, &PotdEngine::error);
+        if (isFileSource(source)) {
+            probeCachedImage(identifier);
+        } else if (!m_loading.contains(identifier)) {
+            CachedProvider *provider = new CachedProvider(identifier, this);
+            m_loading.insert(identifier, provider);
+            connect(provider, &PotdProvider::finished, this, &PotdEngine::finished);
+            connect(provider, &PotdProvider::error, this, &PotdEngine::error);
+        }
 
         m_canDiscardCache = loadCachedAlways;
         if (!loadCachedAlways) {
@@ -88,15 +233,43 @@ bool PotdEngine::updateSource(const QString &identifier, bool loadCachedAlways)
         }
     }
 
+    if (!fetch(identifier)) {
+        return false;
+    }
+
+    m_sourceFetches.insert(identifier);
+    return true;
+}
+
+PotdProvider *PotdEngine::fetch(const QString &identifier)
+{
+    // attach to the download already running for this identifier, if any
+    PotdProvider *provider = m_fetching.value(identifier);
+    if (provider) {
+        return provider;
+    }
+
+    provider = createProvider(identifier);
+    if (provider) {
+        m_fetching.insert(identifier, provider);
+        connect(provider, &PotdProvider::finished, this, &PotdEngine::fetchFinished);
+        connect(provider, &PotdProvider::error, this, &PotdEngine::fetchError);
+    }
+
+    return provider;
+}
+
+PotdProvider *PotdEngine::createProvider(const QString &identifier)
+{
     const QStringList parts = identifier.split(QLatin1Char(':'), Qt::SkipEmptyParts);
     if (parts.empty()) {
         qDebug() << "invalid identifier";
-        return false;
+        return nullptr;
     }
     const QString providerName = parts[0];
     if (!mFactories.contains(providerName)) {
         qDebug() << "invalid provider: " << parts[0];
-        return false;
+        return nullptr;
     }
 
     QVariantList args;
@@ -105,33 +278,63 @@ bool PotdEngine::updateSource(const QString &identifier, bool loadCachedAlways)
         args << parts[i];
     }
 
-    auto factory = KPluginLoader(mFactories[providerName].fileName()).factory();
-    PotdProvider *provider = nullptr;
-    if (factory) {
-        provider = factory->create<PotdProvider>(this, args);
-    }
-    if (provider) {
-        connect(provider, &PotdProvider::finished, this, &PotdEngine::finished);
-        connect(provider, &PotdProvider::error, this, &PotdEngine::error);
-        return true;
+    // keep the factories resident, resolving them is not for free
+    KPluginFactory *factory = m_pluginFactories.value(providerName);
+    if (!factory) {
+        factory = KPluginLoader(mFactories[providerName].fileName()).factory();
+        if (!factory) {
+            return nullptr;
+        }
+        m_pluginFactories.insert(providerName, factory);
     }
 
-    return false;
+    return factory->create<PotdProvider>(this, args);
 }
 
-bool PotdEngine::sourceRequestEvent(const QString &identifier)
+void PotdEngine::updateSources(const QString &identifier)
 {
-    if (updateSource(identifier, true)) {
-        setData(identifier, DataKeys::image(), QImage());
+    if (containerForSource(identifier)) {
+        updateSource(identifier, false);
+    }
+    if (containerForSource(fileSource(identifier))) {
+        updateSource(fileSource(identifier), false);
+    }
+}
+
+bool PotdEngine::sourceRequestEvent(const QString &source)
+{
+    if (source == ioSource()) {
+        publishIoStatistics();
         return true;
     }
 
-    return false;
+    if (!updateSource(source, true)) {
+        return false;
+    }
+
+    if (isHistorySource(source)) {
+        // the days are added once the history has been read
+        setData(source, Plasma::DataEngine::Data());
+    } else if (isFileSource(source)) {
+        setData(source, DataKeys::url(), QString());
+        setData(source, DataKeys::source(), QUrl());
+    } else {
+        setData(source, DataKeys::image(), QImage());
+    }
+    return true;
 }
 
 void PotdEngine::finished(PotdProvider *provider)
 {
-    if (m_canDiscardCache && qobject_cast<CachedProvider *>(provider)) {
+    m_loading.remove(provider->identifier());
+
+    // the source has been disconnected while the picture was loading
+    if (!containerForSource(provider->identifier())) {
+        provider->deleteLater();
+        return;
+    }
+
+    if (m_canDiscardCache) {
         Plasma::DataContainer *source = containerForSource(provider->identifier());
         if (source && !source->data().value(DataKeys::image()).value<QImage>().isNull()) {
             provider->deleteLater();
@@ -139,61 +342,358 @@ void PotdEngine::finished(PotdProvider *provider)
         }
     }
 
-    QImage img(provider->image());
-    // store in cache if it's not the response of a CachedProvider
-    if (qobject_cast<CachedProvider *>(provider) == nullptr && !img.isNull()) {
-        SaveImageThread *thread = new SaveImageThread(provider->identifier(), img);
+    setData(provider->identifier(), DataKeys::image(), provider->image());
+    setData(provider->identifier(), DataKeys::url(), CachedProvider::identifierToPath(provider->identifier()));
+
+    provider->deleteLater();
+}
+
+void PotdEngine::fetchFinished(PotdProvider *provider)
+{
+    const QString identifier = m_fetching.key(provider, provider->identifier());
+    m_fetching.remove(identifier);
+    provider->deleteLater();
+
+    // everybody who asked for this identifier gets the same image
+    const QImage img(provider->image());
+    const bool forSource = m_sourceFetches.remove(identifier);
+    const bool forPrefetch = m_prefetching.remove(identifier);
+    const QDate stagingDate = m_staging.take(identifier);
+
+    // the picture only goes into the history once it has been kept
+    if (!img.isNull() && (forSource || forPrefetch || stagingDate.isValid())) {
+        m_pendingHistory.insert(identifier, {img, provider->remoteUrl(), stagingDate.isValid() ? stagingDate : provider->date()});
+    }
+
+    if (img.isNull()) {
+        if (forSource && containerForSource(identifier)) {
+            setData(identifier, DataKeys::image(), img);
+            setData(identifier, DataKeys::url(), CachedProvider::identifierToPath(identifier));
+        }
+    } else if (forSource || forPrefetch) {
+        // the source only gets the picture once it has been saved
+        SaveImageThread *thread = new SaveImageThread(identifier, img);
         connect(thread, &SaveImageThread::done, this, &PotdEngine::cachingFinished);
-        QThreadPool::globalInstance()->start(thread);
-    } else {
-        setData(provider->identifier(), DataKeys::image(), img);
-        setData(provider->identifier(), DataKeys::url(), CachedProvider::identifierToPath(provider->identifier()));
+        PotdIoExecutor::self()->start(thread, forSource ? PotdIoExecutor::VisiblePriority : PotdIoExecutor::BackgroundPriority);
+    } else if (stagingDate.isValid()) {
+        StageImageThread *thread = new StageImageThread(identifier, img, stagingDate);
+        connect(thread, &StageImageThread::done, this, &PotdEngine::stagingDone);
+        PotdIoExecutor::self()->start(thread, PotdIoExecutor::BackgroundPriority);
     }
 
-    provider->deleteLater();
+    if (forPrefetch) {
+        startPrefetches();
+    }
+}
+
+void PotdEngine::cachingFinished(const QString &identifier, const QString &path, const QImage &img)
+{
+    m_cacheIndex->insert(identifier);
+
+    const auto pending = m_pendingHistory.constFind(identifier);
+    if (pending != m_pendingHistory.constEnd()) {
+        recordHistory(identifier, *pending);
+        m_pendingHistory.erase(pending);
+    }
+
+    // prefetched pictures might not have a source
+    if (containerForSource(identifier)) {
+        setData(identifier, DataKeys::image(), img);
+        setData(identifier, DataKeys::url(), path);
+    }
+
+    if (containerForSource(fileSource(identifier))) {
+        probeCachedImage(identifier);
+    }
+}
+
+void PotdEngine::probeCachedImage(const QString &identifier)
+{
+    ProbeImageThread *thread = new ProbeImageThread(identifier, CachedProvider::identifierToPath(identifier));
+    connect(thread, &ProbeImageThread::done, this, &PotdEngine::probeFinished);
+    PotdIoExecutor::self()->start(thread, PotdIoExecutor::VisiblePriority, fileSource(identifier));
+}
+
+void PotdEngine::publishPlaceholder(const QString &source)
+{
+    // it is only of use until the source has its first picture
+    Plasma::DataContainer *container = containerForSource(source);
+    if (container) {
+        const Plasma::DataEngine::Data data = container->data();
+        if (isFileSource(source) ? !data.value(DataKeys::url()).toString().isEmpty() : !data.value(DataKeys::image()).value<QImage>().isNull()) {
+            return;
+        }
+    }
+
+    // the placeholder is tiny, reading it right away is cheaper than a round trip through the pool
+    const QString identifier = sourceIdentifier(source);
+    const QFileInfo info(CachedProvider::placeholderPath(identifier));
+    if (!info.exists() || info.lastModified() < m_cacheIndex->entry(identifier).lastModified) {
+        return;
+    }
+
+    const QImage placeholder(info.filePath());
+    if (!placeholder.isNull()) {
+        setData(source, DataKeys::placeholder(), placeholder);
+    }
+}
+
+void PotdEngine::dropPendingLoads(const QString &source)
+{
+    if (PotdIoExecutor::self()->cancel(source) == 0 || isFileSource(source)) {
+        return;
+    }
+
+    // the cached picture of this source will not be loaded anymore
+    PotdProvider *provider = m_loading.take(source);
+    if (provider) {
+        provider->disconnect(this);
+        provider->deleteLater();
+    }
+}
+
+void PotdEngine::publishIoStatistics()
+{
+    const PotdIoExecutor::Statistics statistics = PotdIoExecutor::self()->statistics();
+
+    Plasma::DataEngine::Data data;
+    data.insert(DataKeys::queued(), statistics.queued);
+    data.insert(DataKeys::active(), statistics.active);
+    data.insert(DataKeys::lastLatency(), statistics.lastLatency);
+    data.insert(DataKeys::averageLatency(), statistics.averageLatency);
+    setData(ioSource(), data);
 }
 
-void PotdEngine::cachingFinished(const QString &source, const QString &path, const QImage &img)
+void PotdEngine::probeFinished(const QString &identifier, const QString &path, const QSize &size, const QByteArray &hash)
 {
-    setData(source, DataKeys::image(), img);
-    setData(source, DataKeys::url(), path);
+    const QString source = fileSource(identifier);
+    if (!containerForSource(source) || hash.isEmpty()) {
+        return;
+    }
+
+    const QString hexHash = QString::fromLatin1(hash.toHex());
+    // the hash makes sure a new picture in the same file is not taken from a cache
+    QUrl url = QUrl::fromLocalFile(path);
+    url.setQuery(hexHash);
+
+    Plasma::DataEngine::Data data;
+    data.insert(DataKeys::url(), path);
+    data.insert(DataKeys::source(), url);
+    data.insert(DataKeys::width(), size.width());
+    data.insert(DataKeys::height(), size.height());
+    data.insert(DataKeys::hash(), hexHash);
+    setData(source, data);
+}
+
+void PotdEngine::recordHistory(const QString &identifier, const PendingHistory &picture)
+{
+    // only the pictures of the day of the provider itself, not those of e.g. a category
+    const QStringList parts = identifier.split(QLatin1Char(':'), Qt::SkipEmptyParts);
+    if (parts.size() > 2 || (parts.size() == 2 && !PotdCacheIndex::isDatedIdentifier(identifier))) {
+        return;
+    }
+
+    QUrl url = picture.remoteUrl;
+    if (!url.isValid() && parts.size() == 2) {
+        // the cached file of a dated picture does not change
+        url = QUrl::fromLocalFile(CachedProvider::identifierToPath(identifier));
+    }
+
+    RecordHistoryThread *thread = new RecordHistoryThread(parts.first(), picture.date, picture.image, url);
+    connect(thread, &RecordHistoryThread::done, this, &PotdEngine::historyRecorded);
+    PotdIoExecutor::self()->start(thread, PotdIoExecutor::BackgroundPriority);
+}
+
+void PotdEngine::historyRecorded(const QString &provider, const QDate &date)
+{
+    const QString source = historySource(provider, date);
+    if (containerForSource(source)) {
+        loadHistory(source);
+    }
+}
+
+bool PotdEngine::loadHistory(const QString &source)
+{
+    const QStringList parts = source.mid(historyPrefix().size()).split(QLatin1Char(':'));
+    const QDate month = parts.size() == 2 ? QDate::fromString(parts.at(1) + QLatin1String("-01"), Qt::ISODate) : QDate();
+    if (!month.isValid() || !mFactories.contains(parts.at(0))) {
+        qDebug() << "invalid history source:" << source;
+        return false;
+    }
+
+    LoadHistoryThread *thread = new LoadHistoryThread(source, parts.at(0), month);
+    connect(thread, &LoadHistoryThread::done, this, &PotdEngine::historyLoaded);
+    PotdIoExecutor::self()->start(thread, PotdIoExecutor::VisiblePriority, source);
+    return true;
+}
+
+void PotdEngine::historyLoaded(const QString &source, const QVariantMap &data)
+{
+    if (containerForSource(source)) {
+        setData(source, data);
+    }
 }
 
 void PotdEngine::error(PotdProvider *provider)
 {
+    m_loading.remove(provider->identifier());
+
     provider->disconnect(this);
     provider->deleteLater();
 }
 
+void PotdEngine::fetchError(PotdProvider *provider)
+{
+    const QString identifier = m_fetching.key(provider, provider->identifier());
+    m_fetching.remove(identifier);
+
+    provider->disconnect(this);
+    provider->deleteLater();
+
+    m_sourceFetches.remove(identifier);
+    m_staging.remove(identifier);
+    if (m_prefetching.remove(identifier)) {
+        startPrefetches();
+    }
+}
+
 void PotdEngine::checkDayChanged()
 {
     SourceDict dict = containerDict();
     QHashIterator<QString, Plasma::DataContainer *> it(dict);
-    QRegularExpression re(QLatin1String(":\\d{4}-\\d{2}-\\d{2}"));
 
     while (it.hasNext()) {
         it.next();
 
-        if (it.key() == QLatin1String("Providers")) {
+        if (it.key() == QLatin1String("Providers") || it.key() == ioSource() || isHistorySource(it.key())) {
             continue;
         }
 
+        const QString identifier = sourceIdentifier(it.key());
+
         // Check if the identifier contains ISO date string, like 2019-01-09.
         // If so, don't update the picture. Otherwise, update the picture.
-        if (!re.match(it.key()).hasMatch()) {
-            const QString path = CachedProvider::identifierToPath(it.key());
-            if (!QFile::exists(path)) {
+        if (!PotdCacheIndex::isDatedIdentifier(identifier)) {
+            if (m_cacheIndex->promoteStaged(identifier)) {
+                updateSources(identifier);
+            } else if (!m_cacheIndex->isCached(identifier)) {
                 updateSourceEvent(it.key());
             } else {
-                QFileInfo info(path);
-                if (info.lastModified().daysTo(QDateTime::currentDateTime()) >= 1) {
-                    updateSourceEvent(it.key());
-                }
+                stagePicture(identifier);
             }
         }
     }
 }
 
+void PotdEngine::scheduleDayBoundary()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime next(now.date().addDays(1), QTime(0, 1));
+    m_dayBoundaryTimer->start(qMax<qint64>(now.msecsTo(next), 1000));
+}
+
+void PotdEngine::stagePicture(const QString &identifier)
+{
+    // a fresh picture is being downloaded already
+    if (m_fetching.contains(identifier)) {
+        return;
+    }
+
+    const auto it = mFactories.constFind(identifier.section(QLatin1Char(':'), 0, 0));
+    if (it == mFactories.constEnd()) {
+        return;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const QDateTime published = lastPublishTime(*it, now);
+    if (now < published.addSecs(s_publishMarginSecs)) {
+        return;
+    }
+
+    // the cached picture is already the latest one
+    const PotdCacheIndex::Entry cached = m_cacheIndex->entry(identifier);
+    if (!cached.path.isEmpty() && cached.lastModified >= published) {
+        return;
+    }
+
+    const QDate stagedDate = m_cacheIndex->stagedDate(identifier);
+    if (stagedDate.isValid() && stagedDate >= published.date()) {
+        return;
+    }
+
+    const QDateTime lastAttempt = m_lastStagingAttempt.value(identifier);
+    if (lastAttempt.isValid() && lastAttempt.secsTo(now) < s_stagingRetrySecs) {
+        return;
+    }
+
+    if (!fetch(identifier)) {
+        return;
+    }
+
+    m_staging.insert(identifier, published.date());
+    m_lastStagingAttempt.insert(identifier, now);
+}
+
+void PotdEngine::stagingDone(const QString &source, const QDate &date)
+{
+    const PendingHistory pending = m_pendingHistory.take(source);
+    // nothing has been staged if the provider still had the picture which is cached
+    if (!date.isValid()) {
+        return;
+    }
+
+    if (!pending.image.isNull()) {
+        recordHistory(source, pending);
+    }
+
+    m_cacheIndex->insertStaged(source, date);
+
+    // the picture is meant for today already, e.g. east of UTC
+    if (m_cacheIndex->promoteStaged(source)) {
+        updateSources(source);
+    }
+}
+
+Plasma::Service *PotdEngine::serviceForSource(const QString &source)
+{
+    return new PotdService(this, source);
+}
+
+bool PotdEngine::prefetch(const QString &providerName, const QDate &from, const QDate &to)
+{
+    const auto it = mFactories.constFind(providerName);
+    if (it == mFactories.constEnd() || !isDated(*it)) {
+        qDebug() << "provider does not support dates:" << providerName;
+        return false;
+    }
+
+    if (!from.isValid() || !to.isValid() || from > to || from.daysTo(to) >= s_maxPrefetchDays) {
+        qDebug() << "invalid prefetch range:" << from << to;
+        return false;
+    }
+
+    for (QDate date = from; date <= to; date = date.addDays(1)) {
+        const QString identifier = providerName + QLatin1Char(':') + date.toString(Qt::ISODate);
+        if (m_prefetching.contains(identifier) || m_prefetchQueue.contains(identifier) || m_cacheIndex->isCached(identifier, true)) {
+            continue;
+        }
+        m_prefetchQueue.append(identifier);
+    }
+
+    startPrefetches();
+    return true;
+}
+
+void PotdEngine::startPrefetches()
+{
+    while (m_prefetching.size() < s_maxPrefetchJobs && !m_prefetchQueue.isEmpty()) {
+        const QString identifier = m_prefetchQueue.takeFirst();
+        if (fetch(identifier)) {
+            m_prefetching.insert(identifier);
+        }
+    }
+}
+
 K_EXPORT_PLASMA_DATAENGINE_WITH_JSON(potdengine, PotdEngine, "plasma-dataengine-potd.json")
 
 #include "potd.moc"
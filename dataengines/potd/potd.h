@@ -7,13 +7,22 @@
 #ifndef POTD_DATAENGINE_H
 #define POTD_DATAENGINE_H
 
+#include <QDate>
+#include <QImage>
+#include <QSet>
+#include <QSize>
+#include <QUrl>
+
 #include <KPluginMetaData>
 #include <Plasma/DataEngine>
 
+class PotdCacheIndex;
 class PotdProvider;
 
 class QTimer;
 
+class KPluginFactory;
+
 /**
  * This class provides the Pictures of The Day from various online websites.
  *
@@ -23,6 +32,34 @@ class QTimer;
  *   apod:2007-07-19
  *   unsplash:12435322
  *
+ * Pictures of sources without a date are fetched ahead of time shortly after
+ * the provider has published them, and shown from the day they are meant for.
+ * Providers can set X-KDE-PlasmaPoTDProvider-PublishTime (UTC, "HH:mm") in
+ * their metadata if they do not publish at midnight UTC.
+ *
+ * Sources prefixed with "file:", e.g. file:apod, do not carry the decoded
+ * image. They get the path of the cached picture ("Url"), its dimensions
+ * ("Width", "Height") and a hash of its content ("Hash") instead, so the
+ * picture can be loaded asynchronously by whoever shows it. "Source" is a
+ * file url of the picture with the hash as query, ready to be used as the
+ * source of an image.
+ *
+ * Both kinds of sources get a tiny version of a cached picture ("Placeholder")
+ * as soon as they are requested, which can be shown scaled up until the
+ * picture itself is there.
+ *
+ * Providers which set X-KDE-PlasmaPoTDProvider-Dated support identifiers with
+ * a date, and a range of them can be fetched into the cache with the
+ * "prefetch" operation of the service for the provider name.
+ *
+ * A thumbnail and the url of every picture of the day fetched is kept in the
+ * history of the provider. Sources like history:apod:2021-07 get the history
+ * of a month, keyed by the ISO date of the day, see LoadHistoryThread.
+ *
+ * The "IO" source has the number of queued ("Queued") and running ("Active")
+ * file and decoding tasks, and how long the last one took from being queued
+ * to its completion ("LastLatency") and on average ("AverageLatency"), in
+ * milliseconds.
  */
 class PotdEngine : public Plasma::DataEngine
 {
@@ -32,24 +69,76 @@ public:
     PotdEngine(QObject *parent, const QVariantList &args);
     ~PotdEngine() override;
 
+    Plasma::Service *serviceForSource(const QString &source) override;
+
+    /**
+     * Fetches the pictures of @p providerName for every date from @p from to
+     * @p to into the cache, downloading only a few of them at the same time.
+     *
+     * @return false if the provider does not support dated identifiers or
+     *         the range is invalid
+     */
+    bool prefetch(const QString &providerName, const QDate &from, const QDate &to);
+
 protected:
-    bool sourceRequestEvent(const QString &identifier) override;
+    bool sourceRequestEvent(const QString &source) override;
 
 protected Q_SLOTS:
-    bool updateSourceEvent(const QString &identifier) override;
+    bool updateSourceEvent(const QString &source) override;
 
 private Q_SLOTS:
     void finished(PotdProvider *);
     void error(PotdProvider *);
     void checkDayChanged();
-    void cachingFinished(const QString &source, const QString &path, const QImage &img);
+    void cachingFinished(const QString &identifier, const QString &path, const QImage &img);
+    void probeFinished(const QString &identifier, const QString &path, const QSize &size, const QByteArray &hash);
+    void fetchFinished(PotdProvider *provider);
+    void fetchError(PotdProvider *provider);
+    void stagingDone(const QString &source, const QDate &date);
+    void dropPendingLoads(const QString &source);
+    void publishIoStatistics();
+    void historyRecorded(const QString &provider, const QDate &date);
+    void historyLoaded(const QString &source, const QVariantMap &data);
 
 private:
-    bool updateSource(const QString &identifier, bool loadCachedAlways);
+    struct PendingHistory {
+        QImage image;
+        QUrl remoteUrl;
+        QDate date;
+    };
+
+    bool updateSource(const QString &source, bool loadCachedAlways);
+    void updateSources(const QString &identifier);
+    void probeCachedImage(const QString &identifier);
+    void publishPlaceholder(const QString &source);
+    void recordHistory(const QString &identifier, const PendingHistory &picture);
+    bool loadHistory(const QString &source);
+    PotdProvider *fetch(const QString &identifier);
+    PotdProvider *createProvider(const QString &identifier);
+    void stagePicture(const QString &identifier);
+    void startPrefetches();
+    void scheduleDayBoundary();
 
     QMap<QString, KPluginMetaData> mFactories;
+    QHash<QString, KPluginFactory *> m_pluginFactories;
+    PotdCacheIndex *m_cacheIndex;
     QTimer *m_checkDatesTimer;
+    QTimer *m_dayBoundaryTimer;
     bool m_canDiscardCache;
+
+    // identifier -> provider loading it from the cache
+    QHash<QString, PotdProvider *> m_loading;
+    // identifier -> provider downloading it, shared by everybody who needs it
+    QHash<QString, PotdProvider *> m_fetching;
+    // identifiers whose download has been requested by a source
+    QSet<QString> m_sourceFetches;
+    // identifier -> date the picture being fetched ahead of time is meant for
+    QHash<QString, QDate> m_staging;
+    QStringList m_prefetchQueue;
+    QSet<QString> m_prefetching;
+    QHash<QString, QDateTime> m_lastStagingAttempt;
+    // identifier -> fetched picture to add to the history once it has been cached or staged
+    QHash<QString, PendingHistory> m_pendingHistory;
 };
 
 #endif
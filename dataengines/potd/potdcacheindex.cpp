@@ -0,0 +1,214 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "potdcacheindex.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <KDirWatch>
+
+#include "cachedprovider.h"
+
+PotdCacheIndex::PotdCacheIndex(QObject *parent)
+    : QObject(parent)
+    , m_dirWatch(new KDirWatch(this))
+{
+    load();
+
+    // watch the files as well, so changes are reported with the path of the file
+    m_dirWatch->addDir(CachedProvider::cacheDir(), KDirWatch::WatchFiles);
+    m_dirWatch->addDir(CachedProvider::stagingDir(), KDirWatch::WatchFiles);
+    connect(m_dirWatch, &KDirWatch::dirty, this, &PotdCacheIndex::update);
+    connect(m_dirWatch, &KDirWatch::created, this, &PotdCacheIndex::update);
+    connect(m_dirWatch, &KDirWatch::deleted, this, &PotdCacheIndex::update);
+}
+
+PotdCacheIndex::~PotdCacheIndex()
+{
+}
+
+bool PotdCacheIndex::isDatedIdentifier(const QString &identifier)
+{
+    static const QRegularExpression re(QStringLiteral(":\\d{4}-\\d{2}-\\d{2}"));
+    return re.match(identifier).hasMatch();
+}
+
+PotdCacheIndex::Entry PotdCacheIndex::makeEntry(const QFileInfo &info)
+{
+    Entry entry;
+    entry.path = info.filePath();
+    entry.lastModified = info.lastModified();
+    entry.size = info.size();
+    entry.dated = isDatedIdentifier(info.fileName());
+    return entry;
+}
+
+void PotdCacheIndex::load()
+{
+    // the directories might have been removed behind our back
+    QDir dir;
+    dir.mkpath(CachedProvider::cacheDir());
+    dir.mkpath(CachedProvider::stagingDir());
+    dir.mkpath(CachedProvider::placeholderDir());
+
+    m_entries.clear();
+    const QFileInfoList files = QDir(CachedProvider::cacheDir()).entryInfoList(QDir::Files);
+    for (const QFileInfo &info : files) {
+        m_entries.insert(info.fileName(), makeEntry(info));
+    }
+
+    m_staged.clear();
+    const QStringList staged = QDir(CachedProvider::stagingDir()).entryList(QDir::Files);
+    for (const QString &fileName : staged) {
+        const int separator = fileName.lastIndexOf(QLatin1Char('@'));
+        const QDate date = QDate::fromString(fileName.mid(separator + 1), Qt::ISODate);
+        if (separator > 0 && date.isValid()) {
+            m_staged[fileName.left(separator)].append(date);
+        }
+    }
+}
+
+void PotdCacheIndex::update(const QString &path)
+{
+    const QFileInfo info(path);
+    const QString cleanPath = QDir::cleanPath(path);
+
+    if (cleanPath == QDir::cleanPath(CachedProvider::cacheDir()) || cleanPath == QDir::cleanPath(CachedProvider::stagingDir())) {
+        // only a directory which has been removed as a whole needs to be read again
+        if (!info.exists()) {
+            load();
+        }
+        return;
+    }
+
+    const QString dir = QDir::cleanPath(info.absolutePath());
+    if (dir == QDir::cleanPath(CachedProvider::cacheDir())) {
+        updateEntry(info);
+    } else if (dir == QDir::cleanPath(CachedProvider::stagingDir())) {
+        updateStaged(info);
+    }
+}
+
+void PotdCacheIndex::updateEntry(const QFileInfo &info)
+{
+    if (!info.isFile()) {
+        m_entries.remove(info.fileName());
+        return;
+    }
+
+    // the writes of the engine itself have already been recorded by insert()
+    const auto it = m_entries.constFind(info.fileName());
+    if (it != m_entries.constEnd() && it->lastModified == info.lastModified() && it->size == info.size()) {
+        return;
+    }
+
+    m_entries.insert(info.fileName(), makeEntry(info));
+}
+
+void PotdCacheIndex::updateStaged(const QFileInfo &info)
+{
+    const QString fileName = info.fileName();
+    const int separator = fileName.lastIndexOf(QLatin1Char('@'));
+    const QDate date = QDate::fromString(fileName.mid(separator + 1), Qt::ISODate);
+    if (separator <= 0 || !date.isValid()) {
+        return;
+    }
+
+    const QString identifier = fileName.left(separator);
+    if (info.isFile()) {
+        insertStaged(identifier, date);
+        return;
+    }
+
+    auto it = m_staged.find(identifier);
+    if (it != m_staged.end()) {
+        it->removeAll(date);
+        if (it->isEmpty()) {
+            m_staged.erase(it);
+        }
+    }
+}
+
+bool PotdCacheIndex::isCached(const QString &identifier, bool ignoreAge) const
+{
+    const auto it = m_entries.constFind(identifier);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    if (!ignoreAge && !it->dated) {
+        // no date in the identifier, so it's a daily; check to see if the modification time is today
+        if (it->lastModified.daysTo(QDateTime::currentDateTime()) >= 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+PotdCacheIndex::Entry PotdCacheIndex::entry(const QString &identifier) const
+{
+    return m_entries.value(identifier);
+}
+
+QDate PotdCacheIndex::stagedDate(const QString &identifier) const
+{
+    QDate newest;
+    const QList<QDate> dates = m_staged.value(identifier);
+    for (const QDate &date : dates) {
+        if (!newest.isValid() || date > newest) {
+            newest = date;
+        }
+    }
+    return newest;
+}
+
+bool PotdCacheIndex::promoteStaged(const QString &identifier)
+{
+    const QDate date = stagedDate(identifier);
+    if (!date.isValid() || date > QDate::currentDate()) {
+        return false;
+    }
+
+    const QString path = CachedProvider::identifierToPath(identifier);
+    QFile::remove(path);
+    if (!QFile::rename(CachedProvider::stagingPath(identifier, date), path)) {
+        return false;
+    }
+
+    // older staged pictures have been superseded
+    const QList<QDate> dates = m_staged.take(identifier);
+    for (const QDate &staleDate : dates) {
+        if (staleDate != date) {
+            QFile::remove(CachedProvider::stagingPath(identifier, staleDate));
+        }
+    }
+
+    // the cache age is based on the modification time, and the picture is fresh from today on
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    insert(identifier);
+    return true;
+}
+
+void PotdCacheIndex::insert(const QString &identifier)
+{
+    m_entries.insert(identifier, makeEntry(QFileInfo(CachedProvider::identifierToPath(identifier))));
+}
+
+void PotdCacheIndex::insertStaged(const QString &identifier, const QDate &date)
+{
+    QList<QDate> &dates = m_staged[identifier];
+    if (!dates.contains(date)) {
+        dates.append(date);
+    }
+}
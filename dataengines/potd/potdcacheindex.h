@@ -0,0 +1,96 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef POTDCACHEINDEX_H
+#define POTDCACHEINDEX_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+
+class QFileInfo;
+
+class KDirWatch;
+
+/**
+ * This class keeps an in-memory index of the PoTD cache directory.
+ *
+ * The directory is read once, and afterwards the index is kept current by
+ * the engine reporting its own writes, and by a directory watcher for
+ * everything else. Queries never touch the file system.
+ */
+class PotdCacheIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QString path;
+        QDateTime lastModified;
+        qint64 size = 0;
+        bool dated = false;
+    };
+
+    explicit PotdCacheIndex(QObject *parent = nullptr);
+    ~PotdCacheIndex() override;
+
+    /**
+     * Returns whether a picture with the given @p identifier is cached.
+     * Pictures without a date in their identifier are only considered
+     * cached on the day they have been stored, unless @p ignoreAge is set.
+     */
+    bool isCached(const QString &identifier, bool ignoreAge = false) const;
+
+    /**
+     * Returns the cache entry for @p identifier, or an entry with an empty
+     * path if there is none.
+     */
+    Entry entry(const QString &identifier) const;
+
+    /**
+     * Returns the date the staged picture for @p identifier is meant for,
+     * or an invalid date if nothing is staged.
+     */
+    QDate stagedDate(const QString &identifier) const;
+
+    /**
+     * Moves the picture staged for @p identifier into the cache if the day
+     * it is meant for has come.
+     */
+    bool promoteStaged(const QString &identifier);
+
+    /**
+     * Records that the engine has written the picture for @p identifier.
+     */
+    void insert(const QString &identifier);
+
+    /**
+     * Records that the engine has staged a picture for @p identifier.
+     */
+    void insertStaged(const QString &identifier, const QDate &date);
+
+    /**
+     * Returns whether @p identifier contains an ISO date, like 2019-01-09.
+     */
+    static bool isDatedIdentifier(const QString &identifier);
+
+private Q_SLOTS:
+    void load();
+    void update(const QString &path);
+
+private:
+    static Entry makeEntry(const QFileInfo &info);
+    void updateEntry(const QFileInfo &info);
+    void updateStaged(const QFileInfo &info);
+
+    QHash<QString, Entry> m_entries;
+    // identifier -> dates staged pictures are meant for
+    QHash<QString, QList<QDate>> m_staged;
+    KDirWatch *m_dirWatch;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "potdhistory.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSaveFile>
+
+#include "cachedprovider.h"
+
+namespace
+{
+// "PoTH", followed by the version of the format
+constexpr quint32 s_magic = 0x506f5448;
+constexpr quint8 s_version = 1;
+// Width of the thumbnails, big enough for a calendar like view
+constexpr int s_thumbnailWidth = 256;
+
+// day -> JPEG thumbnail and url of the picture
+using Month = QMap<QDate, QPair<QByteArray, QUrl>>;
+
+// serialises updates of the same month from different workers
+QMutex s_writeMutex;
+
+Month readMonth(const QString &path)
+{
+    Month month;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return month;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic;
+    quint8 version;
+    stream >> magic >> version;
+    if (magic != s_magic || version != s_version) {
+        return month;
+    }
+
+    stream >> month;
+    if (stream.status() != QDataStream::Ok) {
+        month.clear();
+    }
+    return month;
+}
+
+bool writeMonth(const QString &path, const Month &month)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << s_magic << s_version << month;
+    return file.commit();
+}
+}
+
+QString PotdHistory::historyDir()
+{
+    return CachedProvider::cacheDir() + QLatin1String("history/");
+}
+
+QString PotdHistory::monthPath(const QString &provider, const QDate &date)
+{
+    return historyDir() + provider + QLatin1Char('@') + date.toString(QStringLiteral("yyyy-MM"));
+}
+
+RecordHistoryThread::RecordHistoryThread(const QString &provider, const QDate &date, const QImage &image, const QUrl &url)
+    : m_provider(provider)
+    , m_date(date)
+    , m_image(image)
+    , m_url(url)
+{
+}
+
+void RecordHistoryThread::run()
+{
+    QByteArray thumbnail;
+    QBuffer buffer(&thumbnail);
+    buffer.open(QIODevice::WriteOnly);
+    m_image.scaledToWidth(qMin(s_thumbnailWidth, m_image.width()), Qt::SmoothTransformation).save(&buffer, "JPEG");
+    buffer.close();
+
+    {
+        QMutexLocker locker(&s_writeMutex);
+
+        QDir().mkpath(PotdHistory::historyDir());
+        const QString path = PotdHistory::monthPath(m_provider, m_date);
+        Month month = readMonth(path);
+        month.insert(m_date, qMakePair(thumbnail, m_url));
+        writeMonth(path, month);
+    }
+
+    Q_EMIT done(m_provider, m_date);
+}
+
+LoadHistoryThread::LoadHistoryThread(const QString &source, const QString &provider, const QDate &date)
+    : m_source(source)
+    , m_provider(provider)
+    , m_date(date)
+{
+}
+
+void LoadHistoryThread::run()
+{
+    const Month month = readMonth(PotdHistory::monthPath(m_provider, m_date));
+
+    QVariantMap data;
+    for (auto it = month.constBegin(); it != month.constEnd(); ++it) {
+        QVariantMap day;
+        day.insert(QStringLiteral("Thumbnail"), QImage::fromData(it->first, "JPEG"));
+        day.insert(QStringLiteral("Url"), it->second);
+        data.insert(it.key().toString(Qt::ISODate), day);
+    }
+
+    Q_EMIT done(m_source, data);
+}
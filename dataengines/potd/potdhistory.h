@@ -0,0 +1,78 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef POTDHISTORY_H
+#define POTDHISTORY_H
+
+#include <QDate>
+#include <QImage>
+#include <QObject>
+#include <QRunnable>
+#include <QUrl>
+#include <QVariantMap>
+
+/**
+ * The history of a provider keeps a thumbnail and the url of the picture of
+ * every day it has been fetched for. There is one file per provider and month,
+ * so browsing a month takes reading a single small file.
+ */
+namespace PotdHistory
+{
+/**
+ * Returns the directory the history files are kept in
+ */
+QString historyDir();
+
+/**
+ * Returns the path of the history file of @p provider for the month of @p date
+ */
+QString monthPath(const QString &provider, const QDate &date);
+}
+
+/**
+ * Adds the picture of @p date to the history of @p provider.
+ */
+class RecordHistoryThread : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    RecordHistoryThread(const QString &provider, const QDate &date, const QImage &image, const QUrl &url);
+    void run() override;
+
+Q_SIGNALS:
+    void done(const QString &provider, const QDate &date);
+
+private:
+    QString m_provider;
+    QDate m_date;
+    QImage m_image;
+    QUrl m_url;
+};
+
+/**
+ * Reads the history of @p provider for the month of @p date. The data has
+ * an entry for every day, keyed by its ISO date, with the thumbnail
+ * ("Thumbnail") and the url of the picture ("Url").
+ */
+class LoadHistoryThread : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LoadHistoryThread(const QString &source, const QString &provider, const QDate &date);
+    void run() override;
+
+Q_SIGNALS:
+    void done(const QString &source, const QVariantMap &data);
+
+private:
+    QString m_source;
+    QString m_provider;
+    QDate m_date;
+};
+
+#endif
@@ -0,0 +1,335 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "potdhtmlscanner.h"
+
+#include <cstring>
+
+#include <KIO/TransferJob>
+
+namespace
+{
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f';
+}
+
+inline bool isLetter(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char toLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// Decodes the character references which matter in urls, leaves everything else alone
+QByteArray decodeReferences(const QByteArray &value)
+{
+    if (!value.contains('&')) {
+        return value;
+    }
+
+    QByteArray result;
+    result.reserve(value.size());
+
+    for (int i = 0; i < value.size(); ++i) {
+        if (value.at(i) != '&') {
+            result.append(value.at(i));
+            continue;
+        }
+
+        // references are short, do not look far for the semicolon
+        int semicolon = -1;
+        for (int j = i + 1; j < value.size() && j <= i + 8; ++j) {
+            if (value.at(j) == ';') {
+                semicolon = j;
+                break;
+            }
+        }
+
+        char decoded = 0;
+        if (semicolon > 0) {
+            const QByteArray reference = value.mid(i + 1, semicolon - i - 1);
+            if (reference == "amp") {
+                decoded = '&';
+            } else if (reference == "quot") {
+                decoded = '"';
+            } else if (reference == "apos") {
+                decoded = '\'';
+            } else if (reference == "lt") {
+                decoded = '<';
+            } else if (reference == "gt") {
+                decoded = '>';
+            } else if (reference.startsWith('#')) {
+                bool ok = false;
+                const bool hex = reference.size() > 1 && toLower(reference.at(1)) == 'x';
+                const int code = hex ? reference.mid(2).toInt(&ok, 16) : reference.mid(1).toInt(&ok);
+                if (ok && code > 0 && code < 128) {
+                    decoded = static_cast<char>(code);
+                }
+            }
+        }
+
+        if (decoded) {
+            result.append(decoded);
+            i = semicolon;
+        } else {
+            result.append('&');
+        }
+    }
+
+    return result;
+}
+}
+
+QByteArray PotdHtmlScanner::Tag::attribute(const QByteArray &name) const
+{
+    for (const auto &attribute : attributes) {
+        if (attribute.first == name) {
+            return attribute.second;
+        }
+    }
+    return QByteArray();
+}
+
+PotdHtmlScanner::PotdHtmlScanner(const TagHandler &handler)
+    : m_handler(handler)
+{
+}
+
+bool PotdHtmlScanner::isStopped() const
+{
+    return m_stopped;
+}
+
+void PotdHtmlScanner::startAttribute(char c)
+{
+    m_attributeName = QByteArray(1, toLower(c));
+    m_attributeValue.clear();
+    m_state = AttributeName;
+}
+
+void PotdHtmlScanner::finishAttribute()
+{
+    m_tag.attributes.append(qMakePair(m_attributeName, decodeReferences(m_attributeValue)));
+    m_attributeName.clear();
+    m_attributeValue.clear();
+    m_state = BeforeAttributeName;
+}
+
+void PotdHtmlScanner::finishTag()
+{
+    m_state = Text;
+    if (m_tag.name == "script" || m_tag.name == "style") {
+        m_rawTextEnd = "</" + m_tag.name;
+        m_rawTextMatched = 0;
+        m_state = RawText;
+    }
+
+    if (!m_handler(m_tag)) {
+        m_stopped = true;
+    }
+    m_tag = Tag();
+}
+
+bool PotdHtmlScanner::addData(const QByteArray &data)
+{
+    const char *it = data.constData();
+    const char *const end = it + data.size();
+
+    while (it != end && !m_stopped) {
+        const char c = *it;
+
+        switch (m_state) {
+        case Text: {
+            // nothing but the next tag matters
+            const void *open = std::memchr(it, '<', end - it);
+            if (!open) {
+                return true;
+            }
+            it = static_cast<const char *>(open) + 1;
+            m_state = TagOpen;
+            continue;
+        }
+        case TagOpen:
+            if (c == '!') {
+                m_dashes = 0;
+                m_state = MarkupDeclaration;
+            } else if (c == '/' || c == '?') {
+                m_state = SkipTag;
+            } else if (isLetter(c)) {
+                m_tag = Tag();
+                m_tag.name = QByteArray(1, toLower(c));
+                m_state = TagName;
+            } else if (c != '<') {
+                m_state = Text;
+            }
+            break;
+        case MarkupDeclaration:
+            if (c == '-') {
+                if (++m_dashes == 2) {
+                    m_dashes = 0;
+                    m_state = Comment;
+                }
+            } else {
+                m_state = c == '>' ? Text : SkipTag;
+            }
+            break;
+        case Comment:
+            if (c == '-') {
+                ++m_dashes;
+            } else if (c == '>' && m_dashes >= 2) {
+                m_state = Text;
+            } else {
+                m_dashes = 0;
+            }
+            break;
+        case SkipTag:
+            if (c == '>') {
+                m_state = Text;
+            }
+            break;
+        case TagName:
+            if (isSpace(c) || c == '/') {
+                m_state = BeforeAttributeName;
+            } else if (c == '>') {
+                finishTag();
+            } else {
+                m_tag.name.append(toLower(c));
+            }
+            break;
+        case BeforeAttributeName:
+            if (c == '>') {
+                finishTag();
+            } else if (!isSpace(c) && c != '/') {
+                startAttribute(c);
+            }
+            break;
+        case AttributeName:
+            if (isSpace(c)) {
+                m_state = AfterAttributeName;
+            } else if (c == '=') {
+                m_state = BeforeAttributeValue;
+            } else if (c == '/') {
+                finishAttribute();
+            } else if (c == '>') {
+                finishAttribute();
+                finishTag();
+            } else {
+                m_attributeName.append(toLower(c));
+            }
+            break;
+        case AfterAttributeName:
+            if (c == '=') {
+                m_state = BeforeAttributeValue;
+            } else if (c == '>') {
+                finishAttribute();
+                finishTag();
+            } else if (c == '/') {
+                finishAttribute();
+            } else if (!isSpace(c)) {
+                finishAttribute();
+                startAttribute(c);
+            }
+            break;
+        case BeforeAttributeValue:
+            if (c == '"') {
+                m_state = AttributeValueDoubleQuoted;
+            } else if (c == '\'') {
+                m_state = AttributeValueSingleQuoted;
+            } else if (c == '>') {
+                finishAttribute();
+                finishTag();
+            } else if (!isSpace(c)) {
+                m_attributeValue.append(c);
+                m_state = AttributeValueUnquoted;
+            }
+            break;
+        case AttributeValueDoubleQuoted:
+        case AttributeValueSingleQuoted: {
+            // copy everything up to the closing quote at once
+            const char quote = m_state == AttributeValueDoubleQuoted ? '"' : '\'';
+            const void *close = std::memchr(it, quote, end - it);
+            const char *stop = close ? static_cast<const char *>(close) : end;
+            m_attributeValue.append(it, stop - it);
+            if (close) {
+                finishAttribute();
+                it = stop + 1;
+            } else {
+                it = end;
+            }
+            continue;
+        }
+        case AttributeValueUnquoted:
+            if (isSpace(c)) {
+                finishAttribute();
+            } else if (c == '>') {
+                finishAttribute();
+                finishTag();
+            } else {
+                m_attributeValue.append(c);
+            }
+            break;
+        case RawText:
+            if (toLower(c) == m_rawTextEnd.at(m_rawTextMatched)) {
+                if (++m_rawTextMatched == m_rawTextEnd.size()) {
+                    m_state = SkipTag;
+                }
+            } else {
+                m_rawTextMatched = c == '<' ? 1 : 0;
+            }
+            break;
+        }
+
+        ++it;
+    }
+
+    return !m_stopped;
+}
+
+PotdHtmlScanJob::PotdHtmlScanJob(const QUrl &url, const PotdHtmlScanner::TagHandler &handler, QObject *parent)
+    : KJob(parent)
+    , m_url(url)
+    , m_scanner(handler)
+{
+}
+
+PotdHtmlScanJob::~PotdHtmlScanJob() = default;
+
+void PotdHtmlScanJob::start()
+{
+    m_transferJob = KIO::get(m_url, KIO::NoReload, KIO::HideProgressInfo);
+    connect(m_transferJob.data(), &KIO::TransferJob::data, this, &PotdHtmlScanJob::transferData);
+    connect(m_transferJob.data(), &KJob::result, this, &PotdHtmlScanJob::transferFinished);
+}
+
+bool PotdHtmlScanJob::doKill()
+{
+    if (m_transferJob) {
+        m_transferJob->disconnect(this);
+        m_transferJob->kill();
+    }
+    return true;
+}
+
+void PotdHtmlScanJob::transferData(KIO::Job *job, const QByteArray &data)
+{
+    Q_UNUSED(job)
+
+    if (!m_scanner.addData(data)) {
+        // everything needed has been found, the rest of the page does not matter
+        doKill();
+        emitResult();
+    }
+}
+
+void PotdHtmlScanJob::transferFinished(KJob *job)
+{
+    if (job->error()) {
+        setError(job->error());
+        setErrorText(job->errorText());
+    }
+    emitResult();
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef POTDHTMLSCANNER_H
+#define POTDHTMLSCANNER_H
+
+#include <QByteArray>
+#include <QPair>
+#include <QPointer>
+#include <QUrl>
+#include <QVector>
+
+#include <KJob>
+
+#include <functional>
+
+#include "plasma_potd_export.h"
+
+namespace KIO
+{
+class Job;
+class TransferJob;
+}
+
+/**
+ * This class extracts the start tags and their attributes from HTML.
+ *
+ * It works on the raw bytes in a single linear pass, without converting
+ * the page to UTF-16, and can be fed the page piece by piece as it is
+ * downloaded. Comments, declarations, end tags and the content of script
+ * and style elements are skipped.
+ *
+ * Tag and attribute names are reported in lower case, attribute values as
+ * they are, with the basic character references decoded.
+ */
+class PLASMA_POTD_EXPORT PotdHtmlScanner
+{
+public:
+    struct Tag {
+        QByteArray name;
+        QVector<QPair<QByteArray, QByteArray>> attributes;
+
+        /**
+         * Returns the value of the attribute @p name (in lower case), or
+         * a null byte array if the tag does not have it.
+         */
+        QByteArray attribute(const QByteArray &name) const;
+    };
+
+    /**
+     * Called for every start tag. Return false once everything needed has
+     * been found, to stop scanning.
+     */
+    using TagHandler = std::function<bool(const Tag &tag)>;
+
+    explicit PotdHtmlScanner(const TagHandler &handler);
+
+    /**
+     * Scans the next piece of the page.
+     *
+     * @return false if the handler has stopped the scanning
+     */
+    bool addData(const QByteArray &data);
+
+    /**
+     * Returns whether the handler has stopped the scanning.
+     */
+    bool isStopped() const;
+
+private:
+    enum State {
+        Text,
+        TagOpen,
+        MarkupDeclaration,
+        Comment,
+        SkipTag,
+        TagName,
+        BeforeAttributeName,
+        AttributeName,
+        AfterAttributeName,
+        BeforeAttributeValue,
+        AttributeValueDoubleQuoted,
+        AttributeValueSingleQuoted,
+        AttributeValueUnquoted,
+        RawText,
+    };
+
+    void startAttribute(char c);
+    void finishAttribute();
+    void finishTag();
+
+    TagHandler m_handler;
+    State m_state = Text;
+    bool m_stopped = false;
+
+    Tag m_tag;
+    QByteArray m_attributeName;
+    QByteArray m_attributeValue;
+
+    // number of dashes seen in a row in comments and declarations
+    int m_dashes = 0;
+    // end tag closing the current raw text element, and how much of it has been seen
+    QByteArray m_rawTextEnd;
+    int m_rawTextMatched = 0;
+};
+
+/**
+ * This job downloads a HTML page and feeds it to a PotdHtmlScanner as it
+ * arrives. The download is stopped as soon as the handler has found what
+ * it is looking for.
+ */
+class PLASMA_POTD_EXPORT PotdHtmlScanJob : public KJob
+{
+    Q_OBJECT
+
+public:
+    PotdHtmlScanJob(const QUrl &url, const PotdHtmlScanner::TagHandler &handler, QObject *parent = nullptr);
+    ~PotdHtmlScanJob() override;
+
+    void start() override;
+
+protected:
+    bool doKill() override;
+
+private:
+    void transferData(KIO::Job *job, const QByteArray &data);
+    void transferFinished(KJob *job);
+
+    QUrl m_url;
+    PotdHtmlScanner m_scanner;
+    QPointer<KIO::TransferJob> m_transferJob;
+};
+
+#endif
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "potdimagejob.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QRunnable>
+#include <QScreen>
+
+#include <KIO/TransferJob>
+
+#include "potdioexecutor.h"
+
+class DecodeImageThread : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    DecodeImageThread(const QByteArray &data, const QSize &targetSize)
+        : m_data(data)
+        , m_targetSize(targetSize)
+    {
+    }
+
+    void run() override
+    {
+        QBuffer buffer(&m_data);
+        buffer.open(QIODevice::ReadOnly);
+
+        QImageReader reader(&buffer);
+        const QSize size = reader.size();
+        if (size.isValid() && m_targetSize.isValid() && size.width() > m_targetSize.width() && size.height() > m_targetSize.height()) {
+            // Only ever scale down, and keep covering the whole target
+            reader.setScaledSize(size.scaled(m_targetSize, Qt::KeepAspectRatioByExpanding));
+        }
+
+        const QImage image = reader.read();
+        if (image.isNull()) {
+            qDebug() << "Failed to decode image:" << reader.errorString();
+        }
+        Q_EMIT done(image);
+    }
+
+Q_SIGNALS:
+    void done(const QImage &image);
+
+private:
+    QByteArray m_data;
+    QSize m_targetSize;
+};
+
+PotdImageJob::PotdImageJob(const QUrl &url, const QSize &targetSize, QObject *parent)
+    : KJob(parent)
+    , m_url(url)
+    , m_targetSize(targetSize.isValid() ? targetSize : defaultTargetSize())
+{
+}
+
+PotdImageJob::~PotdImageJob() = default;
+
+QSize PotdImageJob::defaultTargetSize()
+{
+    QSize size;
+    if (!qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
+        return size;
+    }
+
+    const auto screens = QGuiApplication::screens();
+    for (const QScreen *screen : screens) {
+        size = size.expandedTo(screen->size() * screen->devicePixelRatio());
+    }
+    return size;
+}
+
+void PotdImageJob::start()
+{
+    m_transferJob = KIO::get(m_url, KIO::NoReload, KIO::HideProgressInfo);
+    connect(m_transferJob.data(), &KIO::TransferJob::data, this, &PotdImageJob::transferData);
+    connect(m_transferJob.data(), &KJob::result, this, &PotdImageJob::transferFinished);
+}
+
+QImage PotdImageJob::image() const
+{
+    return m_image;
+}
+
+QUrl PotdImageJob::url() const
+{
+    return m_url;
+}
+
+bool PotdImageJob::doKill()
+{
+    if (m_transferJob) {
+        m_transferJob->disconnect(this);
+        m_transferJob->kill();
+    }
+    return true;
+}
+
+void PotdImageJob::transferData(KIO::Job *job, const QByteArray &data)
+{
+    if (m_data.isEmpty() && job->totalAmount(KJob::Bytes) > 0) {
+        m_data.reserve(static_cast<int>(job->totalAmount(KJob::Bytes)));
+    }
+    m_data.append(data);
+}
+
+void PotdImageJob::transferFinished(KJob *job)
+{
+    if (job->error()) {
+        setError(job->error());
+        setErrorText(job->errorText());
+        emitResult();
+        return;
+    }
+
+    DecodeImageThread *thread = new DecodeImageThread(m_data, m_targetSize);
+    m_data.clear();
+    connect(thread, &DecodeImageThread::done, this, &PotdImageJob::decodingFinished);
+    PotdIoExecutor::self()->start(thread, PotdIoExecutor::NormalPriority);
+}
+
+void PotdImageJob::decodingFinished(const QImage &image)
+{
+    m_image = image;
+    if (m_image.isNull()) {
+        setError(KJob::UserDefinedError);
+        setErrorText(QStringLiteral("Failed to decode %1").arg(m_url.toDisplayString()));
+    }
+    emitResult();
+}
+
+#include "potdimagejob.moc"
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef POTDIMAGEJOB_H
+#define POTDIMAGEJOB_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QPointer>
+#include <QSize>
+#include <QUrl>
+
+#include <KJob>
+
+#include "plasma_potd_export.h"
+
+namespace KIO
+{
+class Job;
+class TransferJob;
+}
+
+/**
+ * This job downloads a picture and decodes it off the GUI thread.
+ *
+ * The transfer is collected as it arrives, and the decoding is done by a
+ * QImageReader on a worker thread. Pictures larger than the target size are
+ * decoded straight to that size, so the memory needed for the decoded image
+ * is bounded by the screen and not by the source.
+ */
+class PLASMA_POTD_EXPORT PotdImageJob : public KJob
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Creates a new image job.
+     *
+     * @param url The url of the picture.
+     * @param targetSize The size the picture has to cover. If invalid,
+     *                   defaultTargetSize() is used.
+     * @param parent The parent object.
+     */
+    explicit PotdImageJob(const QUrl &url, const QSize &targetSize = QSize(), QObject *parent = nullptr);
+
+    ~PotdImageJob() override;
+
+    void start() override;
+
+    /**
+     * Returns the decoded image.
+     *
+     * Note: This method returns only a valid image after the
+     *       result() signal has been emitted without error.
+     */
+    QImage image() const;
+
+    /**
+     * Returns the url of the picture.
+     */
+    QUrl url() const;
+
+    /**
+     * Returns the size pictures are scaled down to when no explicit target
+     * size is given: the largest screen in device pixels, or an invalid size
+     * if there is no screen.
+     */
+    static QSize defaultTargetSize();
+
+protected:
+    bool doKill() override;
+
+private:
+    void transferData(KIO::Job *job, const QByteArray &data);
+    void transferFinished(KJob *job);
+    void decodingFinished(const QImage &image);
+
+    QUrl m_url;
+    QSize m_targetSize;
+    QByteArray m_data;
+    QImage m_image;
+    QPointer<KIO::TransferJob> m_transferJob;
+};
+
+#endif
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "potdioexecutor.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRunnable>
+
+namespace
+{
+// The work is mostly disk bound, more threads would only compete for the disk
+constexpr int s_maxThreads = 2;
+}
+
+Q_GLOBAL_STATIC(PotdIoExecutor, s_executor)
+
+class PotdIoTask : public QRunnable
+{
+public:
+    PotdIoTask(PotdIoExecutor *executor, QRunnable *task, const QString &tag)
+        : m_executor(executor)
+        , m_task(task)
+        , m_tag(tag)
+    {
+        m_queued.start();
+    }
+
+    ~PotdIoTask() override
+    {
+        // also reached when the task is cancelled before running
+        if (m_task->autoDelete()) {
+            delete m_task;
+        }
+    }
+
+    void run() override
+    {
+        m_executor->taskStarted(this);
+        m_task->run();
+        m_executor->taskDone(m_queued.elapsed());
+    }
+
+    QString tag() const
+    {
+        return m_tag;
+    }
+
+private:
+    PotdIoExecutor *const m_executor;
+    QRunnable *const m_task;
+    const QString m_tag;
+    QElapsedTimer m_queued;
+};
+
+PotdIoExecutor *PotdIoExecutor::self()
+{
+    return s_executor();
+}
+
+PotdIoExecutor::PotdIoExecutor(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(s_maxThreads);
+}
+
+PotdIoExecutor::~PotdIoExecutor()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void PotdIoExecutor::start(QRunnable *task, Priority priority, const QString &tag)
+{
+    PotdIoTask *ioTask = new PotdIoTask(this, task, tag);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queued[tag].insert(ioTask);
+        ++m_queuedCount;
+    }
+    m_pool.start(ioTask, priority);
+}
+
+int PotdIoExecutor::cancel(const QString &tag)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QSet<PotdIoTask *> tasks = m_queued.take(tag);
+    int cancelled = 0;
+    for (PotdIoTask *task : tasks) {
+        if (m_pool.tryTake(task)) {
+            delete task;
+            --m_queuedCount;
+            ++cancelled;
+        } else {
+            // picked up by a worker meanwhile, it is waiting for the lock to be started
+            m_queued[tag].insert(task);
+        }
+    }
+
+    return cancelled;
+}
+
+PotdIoExecutor::Statistics PotdIoExecutor::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics;
+    statistics.queued = m_queuedCount;
+    statistics.active = m_activeCount;
+    statistics.lastLatency = m_lastLatency;
+    statistics.averageLatency = m_finishedCount > 0 ? m_totalLatency / m_finishedCount : 0;
+    return statistics;
+}
+
+void PotdIoExecutor::taskStarted(PotdIoTask *task)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_queued.find(task->tag());
+    if (it != m_queued.end()) {
+        it->remove(task);
+        if (it->isEmpty()) {
+            m_queued.erase(it);
+        }
+    }
+    --m_queuedCount;
+    ++m_activeCount;
+}
+
+void PotdIoExecutor::taskDone(qint64 latency)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_activeCount;
+        ++m_finishedCount;
+        m_lastLatency = latency;
+        m_totalLatency += latency;
+    }
+    Q_EMIT taskFinished();
+}
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef POTDIOEXECUTOR_H
+#define POTDIOEXECUTOR_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+
+#include "plasma_potd_export.h"
+
+class QRunnable;
+class PotdIoTask;
+
+/**
+ * This class runs the file and decoding work of the Picture of the Day
+ * engine on a small pool of its own, instead of the global thread pool
+ * which is shared with everything else in the process.
+ *
+ * Tasks are started in order of priority, so loading the picture somebody
+ * is looking at does not wait for caching pictures fetched in the
+ * background. Tasks which have not been started yet can be cancelled by
+ * the tag they were queued with, e.g. when the source they were meant for
+ * has been disconnected.
+ */
+class PLASMA_POTD_EXPORT PotdIoExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        BackgroundPriority = 0, ///< caching and staging pictures nobody waits for
+        NormalPriority = 1, ///< decoding downloaded pictures
+        VisiblePriority = 2, ///< loading pictures which are shown
+    };
+
+    struct Statistics {
+        int queued = 0;
+        int active = 0;
+        // milliseconds from queueing to completion
+        qint64 lastLatency = 0;
+        qint64 averageLatency = 0;
+    };
+
+    /**
+     * Returns the executor shared by the engine and the providers.
+     */
+    static PotdIoExecutor *self();
+
+    explicit PotdIoExecutor(QObject *parent = nullptr);
+    ~PotdIoExecutor() override;
+
+    /**
+     * Queues @p task. The executor takes ownership of it if it has autoDelete set.
+     *
+     * @param task The task to run.
+     * @param priority The priority of the task.
+     * @param tag What the task is done for, so it can be cancelled.
+     */
+    void start(QRunnable *task, Priority priority, const QString &tag = QString());
+
+    /**
+     * Drops the tasks queued with @p tag which have not been started yet.
+     * Tasks already running are not interrupted.
+     *
+     * @return the number of tasks which have been dropped
+     */
+    int cancel(const QString &tag);
+
+    Statistics statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted from the worker thread whenever a task has been completed.
+     */
+    void taskFinished();
+
+private:
+    friend class PotdIoTask;
+
+    void taskStarted(PotdIoTask *task);
+    void taskDone(qint64 latency);
+
+    QThreadPool m_pool;
+
+    mutable QMutex m_mutex;
+    QHash<QString, QSet<PotdIoTask *>> m_queued;
+    int m_queuedCount = 0;
+    int m_activeCount = 0;
+    qint64 m_lastLatency = 0;
+    qint64 m_totalLatency = 0;
+    qint64 m_finishedCount = 0;
+};
+
+#endif
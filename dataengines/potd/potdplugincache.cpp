@@ -0,0 +1,122 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "potdplugincache.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <KPluginLoader>
+
+namespace
+{
+// bump whenever the layout of the cache file changes
+constexpr int s_cacheVersion = 1;
+
+QString cachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/plasma_engine_potd_plugins.json");
+}
+
+qint64 modificationTime(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+// the directories KPluginLoader::findPlugins() looks into, with their modification times
+QJsonArray pluginDirs()
+{
+    QJsonArray dirs;
+    const QStringList libraryPaths = QCoreApplication::libraryPaths();
+    for (const QString &libraryPath : libraryPaths) {
+        const QString path = libraryPath + QLatin1String("/potd");
+        dirs.append(QJsonObject{
+            {QStringLiteral("path"), path},
+            {QStringLiteral("mtime"), modificationTime(path)},
+        });
+    }
+    return dirs;
+}
+}
+
+QVector<KPluginMetaData> PotdPluginCache::findPlugins()
+{
+    const QJsonArray dirs = pluginDirs();
+
+    QVector<KPluginMetaData> plugins;
+    if (readCache(dirs, plugins)) {
+        return plugins;
+    }
+
+    plugins = KPluginLoader::findPlugins(QStringLiteral("potd"), [](const KPluginMetaData &md) {
+        return md.serviceTypes().contains(QStringLiteral("PlasmaPoTD/Plugin"));
+    });
+    writeCache(dirs, plugins);
+
+    return plugins;
+}
+
+bool PotdPluginCache::readCache(const QJsonArray &dirs, QVector<KPluginMetaData> &plugins)
+{
+    QFile file(cachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QJsonObject cache = QJsonDocument::fromJson(file.readAll()).object();
+    if (cache.value(QStringLiteral("version")).toInt() != s_cacheVersion || cache.value(QStringLiteral("dirs")).toArray() != dirs) {
+        return false;
+    }
+
+    const QJsonArray entries = cache.value(QStringLiteral("plugins")).toArray();
+    plugins.reserve(entries.size());
+    for (const QJsonValue &value : entries) {
+        const QJsonObject entry = value.toObject();
+        const QString fileName = entry.value(QStringLiteral("file")).toString();
+        if (modificationTime(fileName) != entry.value(QStringLiteral("mtime")).toVariant().toLongLong()) {
+            plugins.clear();
+            return false;
+        }
+        plugins.append(KPluginMetaData(entry.value(QStringLiteral("metadata")).toObject(), fileName));
+    }
+
+    return true;
+}
+
+void PotdPluginCache::writeCache(const QJsonArray &dirs, const QVector<KPluginMetaData> &plugins)
+{
+    QJsonArray entries;
+    for (const KPluginMetaData &metadata : plugins) {
+        entries.append(QJsonObject{
+            {QStringLiteral("file"), metadata.fileName()},
+            {QStringLiteral("mtime"), modificationTime(metadata.fileName())},
+            {QStringLiteral("metadata"), metadata.rawData()},
+        });
+    }
+
+    const QJsonObject cache{
+        {QStringLiteral("version"), s_cacheVersion},
+        {QStringLiteral("dirs"), dirs},
+        {QStringLiteral("plugins"), entries},
+    };
+
+    QSaveFile file(cachePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Failed to write the PoTD plugin cache:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    file.commit();
+}
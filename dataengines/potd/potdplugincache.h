@@ -0,0 +1,37 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef POTDPLUGINCACHE_H
+#define POTDPLUGINCACHE_H
+
+#include <QVector>
+
+#include <KPluginMetaData>
+
+class QJsonArray;
+
+/**
+ * This class keeps the metadata of the PoTD provider plugins in a small
+ * cache file, so the plugin directories do not have to be searched and
+ * every plugin does not have to be opened each time the engine starts.
+ *
+ * The cache is valid as long as the modification times of the plugin
+ * directories and of every cached plugin file are unchanged.
+ */
+class PotdPluginCache
+{
+public:
+    /**
+     * Returns the metadata of all PoTD provider plugins.
+     */
+    static QVector<KPluginMetaData> findPlugins();
+
+private:
+    static bool readCache(const QJsonArray &dirs, QVector<KPluginMetaData> &plugins);
+    static void writeCache(const QJsonArray &dirs, const QVector<KPluginMetaData> &plugins);
+};
+
+#endif
@@ -19,6 +19,7 @@ public:
     QString name;
     QDate date;
     QString identifier;
+    QUrl remoteUrl;
 };
 
 PotdProvider::PotdProvider(QObject *parent, const QVariantList &args)
@@ -69,6 +70,16 @@ bool PotdProvider::isFixedDate() const
     return !d->date.isNull();
 }
 
+QUrl PotdProvider::remoteUrl() const
+{
+    return d->remoteUrl;
+}
+
+void PotdProvider::setRemoteUrl(const QUrl &url)
+{
+    d->remoteUrl = url;
+}
+
 QString PotdProvider::identifier() const
 {
     return d->identifier;
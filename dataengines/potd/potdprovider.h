@@ -65,6 +65,11 @@ public:
      */
     bool isFixedDate() const;
 
+    /**
+     * @return the url the picture has been downloaded from, if known
+     */
+    QUrl remoteUrl() const;
+
     void refreshConfig();
     void loadConfig();
 
@@ -86,6 +91,12 @@ Q_SIGNALS:
 
     void configLoaded(QString apiKey, QString apiSecret);
 
+protected:
+    /**
+     * Remembers the url of the picture, to be called by the providers once they know it.
+     */
+    void setRemoteUrl(const QUrl &url);
+
 private:
     void configRequestFinished(KJob *job);
     void configWriteFinished(KJob *job);
@@ -0,0 +1,42 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "potdservice.h"
+
+#include <QDate>
+
+#include "potd.h"
+
+PotdService::PotdService(PotdEngine *engine, const QString &providerName)
+    : Plasma::Service(engine)
+    , m_engine(engine)
+{
+    setName(QStringLiteral("org.kde.plasma.dataengine.potd"));
+    setDestination(providerName);
+}
+
+Plasma::ServiceJob *PotdService::createJob(const QString &operation, QMap<QString, QVariant> &parameters)
+{
+    return new PotdPrefetchJob(m_engine, this, operation, parameters);
+}
+
+PotdPrefetchJob::PotdPrefetchJob(PotdEngine *engine, PotdService *service, const QString &operation, const QMap<QString, QVariant> &parameters)
+    : Plasma::ServiceJob(service->destination(), operation, parameters, service)
+    , m_engine(engine)
+{
+}
+
+void PotdPrefetchJob::start()
+{
+    if (operationName() == QLatin1String("prefetch")) {
+        const QDate from = QDate::fromString(parameters().value(QStringLiteral("From")).toString(), Qt::ISODate);
+        const QDate to = QDate::fromString(parameters().value(QStringLiteral("To")).toString(), Qt::ISODate);
+        setResult(m_engine->prefetch(destination(), from, to));
+        return;
+    }
+
+    setResult(false);
+}
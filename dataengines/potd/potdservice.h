@@ -0,0 +1,44 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef POTDSERVICE_H
+#define POTDSERVICE_H
+
+#include <Plasma/Service>
+#include <Plasma/ServiceJob>
+
+class PotdEngine;
+
+/**
+ * This service operates on a PoTD provider, the destination is its identifier.
+ */
+class PotdService : public Plasma::Service
+{
+    Q_OBJECT
+
+public:
+    PotdService(PotdEngine *engine, const QString &providerName);
+
+protected:
+    Plasma::ServiceJob *createJob(const QString &operation, QMap<QString, QVariant> &parameters) override;
+
+private:
+    PotdEngine *m_engine;
+};
+
+class PotdPrefetchJob : public Plasma::ServiceJob
+{
+    Q_OBJECT
+
+public:
+    PotdPrefetchJob(PotdEngine *engine, PotdService *service, const QString &operation, const QMap<QString, QVariant> &parameters);
+    void start() override;
+
+private:
+    PotdEngine *m_engine;
+};
+
+#endif
@@ -12,6 +12,8 @@
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdimagejob.h"
+
 UnsplashProvider::UnsplashProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
@@ -25,8 +27,10 @@ UnsplashProvider::UnsplashProvider(QObject *parent, const QVariantList &args)
     }
     const QUrl url(QStringLiteral("https://source.unsplash.com/collection/%1/3840x2160/daily").arg(collectionId));
 
-    KIO::StoredTransferJob *job = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
-    connect(job, &KIO::StoredTransferJob::finished, this, &UnsplashProvider::imageRequestFinished);
+    setRemoteUrl(url);
+    PotdImageJob *imageJob = new PotdImageJob(url, QSize(), this);
+    connect(imageJob, &KJob::finished, this, &UnsplashProvider::imageRequestFinished);
+    imageJob->start();
 }
 
 UnsplashProvider::~UnsplashProvider() = default;
@@ -38,13 +42,13 @@ QImage UnsplashProvider::image() const
 
 void UnsplashProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
-    QByteArray data = job->data();
-    mImage = QImage::fromData(data);
+
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
@@ -16,6 +16,8 @@
 #include <KIO/Job>
 #include <KPluginFactory>
 
+#include "potdimagejob.h"
+
 WcpotdProvider::WcpotdProvider(QObject *parent, const QVariantList &args)
     : PotdProvider(parent, args)
 {
@@ -54,8 +56,10 @@ void WcpotdProvider::pageRequestFinished(KJob *_job)
         const QString imageFile = jsonImageArray.at(0).toString();
         if (!imageFile.isEmpty()) {
             const QUrl picUrl(QLatin1String("https://commons.wikimedia.org/wiki/Special:FilePath/") + imageFile);
-            KIO::StoredTransferJob *imageJob = KIO::storedGet(picUrl, KIO::NoReload, KIO::HideProgressInfo);
-            connect(imageJob, &KIO::StoredTransferJob::finished, this, &WcpotdProvider::imageRequestFinished);
+            setRemoteUrl(picUrl);
+            PotdImageJob *imageJob = new PotdImageJob(picUrl, QSize(), this);
+            connect(imageJob, &KJob::finished, this, &WcpotdProvider::imageRequestFinished);
+            imageJob->start();
             return;
         }
     }
@@ -65,13 +69,13 @@ void WcpotdProvider::pageRequestFinished(KJob *_job)
 
 void WcpotdProvider::imageRequestFinished(KJob *_job)
 {
-    KIO::StoredTransferJob *job = static_cast<KIO::StoredTransferJob *>(_job);
+    PotdImageJob *job = static_cast<PotdImageJob *>(_job);
     if (job->error()) {
         Q_EMIT error(this);
         return;
     }
-    QByteArray data = job->data();
-    mImage = QImage::fromData(data);
+
+    mImage = job->image();
     Q_EMIT finished(this);
 }
 
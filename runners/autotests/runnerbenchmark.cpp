@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include <KPluginMetaData>
+#include <KRunner/RunnerManager>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+// Counts the heap allocations of the whole process, runner threads included
+static std::atomic<quint64> s_allocations{0};
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+}
+static const bool s_countsAllocations = true;
+#else
+static const bool s_countsAllocations = false;
+#endif
+
+// Time to wait for a single query, the dictionary runner may wait long for the network
+static const int s_queryTimeout = 60000;
+
+/**
+ * Replays what users type through each runner of this repository, one
+ * keystroke at a time, and reports how long the queries take and how many
+ * allocations they make.
+ *
+ * A query is timed from launching it to the manager reporting it finished,
+ * which is what the user waits for, so it includes scheduling the match jobs.
+ */
+class RunnerBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkRunner_data();
+    void benchmarkRunner();
+};
+
+void RunnerBenchmark::initTestCase()
+{
+    // keep the configuration and data of the user out of it
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void RunnerBenchmark::benchmarkRunner_data()
+{
+    QTest::addColumn<QString>("pluginPath");
+    QTest::addColumn<QStringList>("corpus");
+    QTest::addColumn<int>("rounds");
+
+    QTest::newRow("converter") << QStringLiteral(CONVERTER_RUNNER)
+                               << QStringList{QStringLiteral("12.5 km to mi"),
+                                              QStringLiteral("100 usd in eur"),
+                                              QStringLiteral("3/4 l > ml"),
+                                              QStringLiteral("72 fahrenheit as celsius"),
+                                              QStringLiteral("1Ms as ms"),
+                                              QStringLiteral("20 kg")}
+                               << 3;
+    QTest::newRow("datetime") << QStringLiteral(DATETIME_RUNNER)
+                              << QStringList{QStringLiteral("time berlin"),
+                                             QStringLiteral("date new york"),
+                                             QStringLiteral("time cest"),
+                                             QStringLiteral("time utc"),
+                                             QStringLiteral("date india")}
+                              << 3;
+    QTest::newRow("spellchecker") << QStringLiteral(SPELLCHECK_RUNNER)
+                                  << QStringList{QStringLiteral("spell recieve"),
+                                                 QStringLiteral("spell necessary"),
+                                                 QStringLiteral("spell acommodation"),
+                                                 QStringLiteral("spell de Straße")}
+                                  << 3;
+    // every lookup goes to the dictionary server
+    QTest::newRow("dictionary") << QStringLiteral(DICTIONARY_RUNNER) << QStringList{QStringLiteral("define cat"), QStringLiteral("define plasma")} << 1;
+    QTest::newRow("katesessions") << QStringLiteral(KATESESSIONS_RUNNER)
+                                  << QStringList{QStringLiteral("kate"), QStringLiteral("kate plasma"), QStringLiteral("kate work")} << 3;
+#ifdef KONSOLEPROFILES_RUNNER
+    QTest::newRow("konsoleprofiles") << QStringLiteral(KONSOLEPROFILES_RUNNER)
+                                     << QStringList{QStringLiteral("konsole"), QStringLiteral("konsole shell"), QStringLiteral("konsole root")} << 3;
+#endif
+    QTest::newRow("characters") << QStringLiteral(CHARACTER_RUNNER) << QStringList{QStringLiteral("#2013"), QStringLiteral("#1f600"), QStringLiteral("#00e9")}
+                                << 3;
+}
+
+void RunnerBenchmark::benchmarkRunner()
+{
+    QFETCH(QString, pluginPath);
+    QFETCH(QStringList, corpus);
+    QFETCH(int, rounds);
+
+    const KPluginMetaData metaData(pluginPath);
+    QVERIFY(metaData.isValid());
+
+    Plasma::RunnerManager manager;
+    manager.loadRunner(metaData);
+    QVERIFY(manager.runner(metaData.pluginId()));
+
+    QVector<qint64> latencies;
+    quint64 allocations = 0;
+
+    for (int round = 0; round < rounds; ++round) {
+        for (const QString &query : qAsConst(corpus)) {
+            // one match session per query, as if it was typed into a fresh KRunner
+            for (int length = 1; length <= query.length(); ++length) {
+                QSignalSpy finished(&manager, &Plasma::RunnerManager::queryFinished);
+                const quint64 allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+                QElapsedTimer timer;
+                timer.start();
+
+                manager.launchQuery(query.left(length));
+                QVERIFY(!finished.isEmpty() || finished.wait(s_queryTimeout));
+
+                latencies.append(timer.nsecsElapsed());
+                allocations += s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+            }
+            manager.matchSessionComplete();
+        }
+    }
+
+    QVERIFY(!latencies.isEmpty());
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](int percent) {
+        return latencies.at((latencies.size() - 1) * percent / 100) / 1000;
+    };
+
+    qInfo("%s: %d queries, p50 %lld us, p99 %lld us, %s allocations per query",
+          QTest::currentDataTag(),
+          latencies.size(),
+          percentile(50),
+          percentile(99),
+          s_countsAllocations ? qPrintable(QString::number(allocations / latencies.size())) : "unknown");
+    QTest::setBenchmarkResult(percentile(50) / 1000.0, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(RunnerBenchmark)
+
+#include "runnerbenchmark.moc"
@@ -7,9 +7,15 @@
 #include <KRunner/AbstractRunnerTest>
 #include <KUnitConversion/Converter>
 #include <KUnitConversion/UnitCategory>
+#include <QElapsedTimer>
 #include <QRegularExpression>
+#include <QStandardPaths>
 #include <QTest>
 
+#include <algorithm>
+
+#include "converterrunner.h"
+
 using namespace KUnitConversion;
 
 class ConverterRunnerTest : public AbstractRunnerTest
@@ -26,11 +32,34 @@ private Q_SLOTS:
     void testInvalidQuery_data();
     void testInvalidQuery();
     void testRoundingOfCurrencies();
+    void testRepeatedQuery();
+    void testChangedNumber();
+    void testTeardownClearsCaches();
+
+private:
+    ConverterRunner *converterRunner() const
+    {
+        return static_cast<ConverterRunner *>(runner);
+    }
 };
 
 void ConverterRunnerTest::initTestCase()
 {
+    // keep the unit cache of the user out of it
+    QStandardPaths::setTestModeEnabled(true);
     initProperties();
+
+    // The exchange rates are loaded in the background once a query starts, wait for them
+    QElapsedTimer timer;
+    timer.start();
+    launchQuery(QStringLiteral("1$"));
+    while (manager->matches().isEmpty() && !timer.hasExpired(30000)) {
+        QTest::qWait(100);
+        launchQuery(QStringLiteral("1$"));
+    }
+    if (manager->matches().isEmpty()) {
+        QFAIL("The exchange rates could not be loaded within 30 seconds, they are downloaded the first time");
+    }
 }
 
 /**
@@ -140,6 +169,64 @@ void ConverterRunnerTest::testRoundingOfCurrencies()
     QVERIFY(manager->matches().constFirst().text().contains(hasTwoDecimalPrescision));
 }
 
+/**
+ * Test if a query answered from the cache gives the same matches as the first time
+ */
+void ConverterRunnerTest::testRepeatedQuery()
+{
+    const auto matchesOf = [this]() {
+        QList<Plasma::QueryMatch> matches = manager->matches();
+        std::sort(matches.begin(), matches.end(), [](const Plasma::QueryMatch &left, const Plasma::QueryMatch &right) {
+            return left.text() < right.text();
+        });
+        return matches;
+    };
+
+    launchQuery(QStringLiteral("1m"));
+    const QList<Plasma::QueryMatch> first = matchesOf();
+    QVERIFY(!first.isEmpty());
+    launchQuery(QStringLiteral("1m"));
+    const QList<Plasma::QueryMatch> second = matchesOf();
+
+    QCOMPARE(second.size(), first.size());
+    for (int i = 0; i < first.size(); ++i) {
+        QCOMPARE(second.at(i).text(), first.at(i).text());
+        QCOMPARE(second.at(i).subtext(), first.at(i).subtext());
+        QCOMPARE(second.at(i).relevance(), first.at(i).relevance());
+    }
+}
+
+/**
+ * Test if the units resolved for a query are not taken for its result
+ */
+void ConverterRunnerTest::testChangedNumber()
+{
+    launchQuery(QStringLiteral("1m > cm"));
+    QCOMPARE(manager->matches().count(), 1);
+    QCOMPARE(manager->matches().constFirst().text(), QStringLiteral("100 centimeters (cm)"));
+
+    launchQuery(QStringLiteral("2m > cm"));
+    QCOMPARE(manager->matches().count(), 1);
+    QCOMPARE(manager->matches().constFirst().text(), QStringLiteral("200 centimeters (cm)"));
+
+    launchQuery(QStringLiteral("1m > cm"));
+    QCOMPARE(manager->matches().constFirst().text(), QStringLiteral("100 centimeters (cm)"));
+}
+
+void ConverterRunnerTest::testTeardownClearsCaches()
+{
+    manager->setupMatchSession();
+    launchQuery(QStringLiteral("1m > cm"));
+    QVERIFY(!converterRunner()->matchCache.isEmpty());
+    QVERIFY(!converterRunner()->resolvedUnitCache.isEmpty());
+    QVERIFY(!converterRunner()->resultUnitCache.isEmpty());
+
+    manager->matchSessionComplete();
+    QTRY_VERIFY(converterRunner()->matchCache.isEmpty());
+    QVERIFY(converterRunner()->resolvedUnitCache.isEmpty());
+    QVERIFY(converterRunner()->resultUnitCache.isEmpty());
+}
+
 QTEST_MAIN(ConverterRunnerTest)
 
 #include "converterrunnertest.moc"
@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "currencyrates.h"
+
+class CurrencyRatesTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testConvert();
+    void testConvertUnknown();
+    void testIsFresh_data();
+    void testIsFresh();
+    void testTableIsFresh();
+    void testDescription();
+
+private:
+    static QString tablePath();
+
+    QDateTime m_tableModified;
+};
+
+QString CurrencyRatesTest::tablePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/libkunitconversion/currency.xml");
+}
+
+void CurrencyRatesTest::initTestCase()
+{
+    // the rates of the converter test are in the same place, leave them as they are
+    QStandardPaths::setTestModeEnabled(true);
+    m_tableModified = QFileInfo(tablePath()).lastModified();
+}
+
+void CurrencyRatesTest::cleanupTestCase()
+{
+    if (!m_tableModified.isValid()) {
+        QFile::remove(tablePath());
+        return;
+    }
+    QFile table(tablePath());
+    if (table.open(QIODevice::ReadWrite)) {
+        table.setFileTime(m_tableModified, QFileDevice::FileModificationTime);
+    }
+}
+
+void CurrencyRatesTest::testConvert()
+{
+    CurrencySnapshot snapshot;
+    snapshot.perEuro = {{QStringLiteral("EUR"), 1.0}, {QStringLiteral("USD"), 1.25}, {QStringLiteral("GBP"), 0.8}};
+
+    double result = 0;
+    QVERIFY(snapshot.convert(10, QStringLiteral("EUR"), QStringLiteral("USD"), result));
+    QCOMPARE(result, 12.5);
+    QVERIFY(snapshot.convert(12.5, QStringLiteral("USD"), QStringLiteral("GBP"), result));
+    QCOMPARE(result, 8.0);
+    QVERIFY(snapshot.convert(-4, QStringLiteral("GBP"), QStringLiteral("GBP"), result));
+    QCOMPARE(result, -4.0);
+}
+
+void CurrencyRatesTest::testConvertUnknown()
+{
+    CurrencySnapshot snapshot;
+    snapshot.perEuro = {{QStringLiteral("EUR"), 1.0}, {QStringLiteral("XXX"), 0.0}};
+
+    double result = 42;
+    QVERIFY(!snapshot.convert(1, QStringLiteral("EUR"), QStringLiteral("USD"), result));
+    QVERIFY(!snapshot.convert(1, QStringLiteral("USD"), QStringLiteral("EUR"), result));
+    // a currency without a rate would divide by zero
+    QVERIFY(!snapshot.convert(1, QStringLiteral("XXX"), QStringLiteral("EUR"), result));
+    QCOMPARE(result, 42.0);
+}
+
+void CurrencyRatesTest::testIsFresh_data()
+{
+    QTest::addColumn<QDateTime>("updated");
+    QTest::addColumn<bool>("fresh");
+
+    const QDateTime now = QDateTime::currentDateTime();
+    QTest::newRow("never") << QDateTime() << false;
+    QTest::newRow("now") << now << true;
+    QTest::newRow("22 hours ago") << now.addSecs(-22 * 60 * 60) << true;
+    // KUnitConversion downloads them again after a day, that must not be reached
+    QTest::newRow("23 hours ago") << now.addSecs(-23 * 60 * 60) << false;
+    QTest::newRow("two days ago") << now.addDays(-2) << false;
+}
+
+void CurrencyRatesTest::testIsFresh()
+{
+    QFETCH(QDateTime, updated);
+    QFETCH(bool, fresh);
+
+    CurrencySnapshot snapshot;
+    snapshot.updated = updated;
+    QCOMPARE(snapshot.isFresh(), fresh);
+}
+
+void CurrencyRatesTest::testTableIsFresh()
+{
+    QFile::remove(tablePath());
+    QVERIFY(!CurrencyRates::tableIsFresh());
+
+    QVERIFY(QDir().mkpath(QFileInfo(tablePath()).path()));
+    QFile table(tablePath());
+    QVERIFY(table.open(QIODevice::ReadWrite));
+    QVERIFY(CurrencyRates::tableIsFresh());
+
+    QVERIFY(table.setFileTime(QDateTime::currentDateTime().addDays(-2), QFileDevice::FileModificationTime));
+    QVERIFY(!CurrencyRates::tableIsFresh());
+}
+
+/**
+ * Test if results from outdated rates tell when the rates are from
+ */
+void CurrencyRatesTest::testDescription()
+{
+    CurrencySnapshot snapshot;
+    QVERIFY(!snapshot.description().isEmpty());
+
+    snapshot.updated = QDateTime::currentDateTime().addDays(-2);
+    QVERIFY(snapshot.description().contains(QLocale().toString(snapshot.updated, QLocale::ShortFormat)));
+}
+
+QTEST_GUILESS_MAIN(CurrencyRatesTest)
+
+#include "currencyratestest.moc"
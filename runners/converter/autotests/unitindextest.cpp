@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <KUnitConversion/Converter>
+#include <KUnitConversion/UnitCategory>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "unitindex.h"
+
+using namespace KUnitConversion;
+
+class UnitIndexTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+    void testUnit();
+    void testCompletions();
+    void testEmptyIndex();
+    void testCacheIsWritten();
+    void testCacheIsRead();
+    void testUnsortedCache_data();
+    void testUnsortedCache();
+};
+
+void UnitIndexTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(UnitIndex::cachePath());
+}
+
+void UnitIndexTest::cleanup()
+{
+    QFile::remove(UnitIndex::cachePath());
+}
+
+/**
+ * Test if names and symbols are found case insensitively, and only as a whole
+ */
+void UnitIndexTest::testUnit()
+{
+    Converter converter;
+    const UnitIndex index = UnitIndex::load(converter);
+    const UnitCategory length = converter.category(LengthCategory);
+
+    QVERIFY(length.hasUnit(index.unit(QStringLiteral("km"))));
+    QCOMPARE(index.unit(QStringLiteral("KiLoMeTeR")), index.unit(QStringLiteral("kilometer")));
+    QVERIFY(length.hasUnit(index.unit(QStringLiteral("kilometer"))));
+    QCOMPARE(index.unit(QStringLiteral("€")), QStringLiteral("EUR"));
+
+    QVERIFY(index.unit(QStringLiteral("kilomete")).isEmpty());
+    QVERIFY(index.unit(QStringLiteral("kilometerx")).isEmpty());
+    QVERIFY(index.unit(QString()).isEmpty());
+}
+
+/**
+ * Test if the units with a name starting with a prefix are found
+ */
+void UnitIndexTest::testCompletions()
+{
+    Converter converter;
+    const UnitIndex index = UnitIndex::load(converter);
+    const UnitCategory length = converter.category(LengthCategory);
+
+    const QStringList completions = index.completions(QStringLiteral("kilomet"));
+    QVERIFY(!completions.isEmpty());
+    for (const QString &unit : completions) {
+        QVERIFY2(length.hasUnit(unit), qPrintable(unit));
+    }
+    QCOMPARE(index.completions(QStringLiteral("KILOMET")), completions);
+
+    // the whole name is a completion of itself
+    QVERIFY(index.completions(QStringLiteral("kilometer")).contains(index.unit(QStringLiteral("kilometer"))));
+    QVERIFY(index.completions(QStringLiteral("xyzzy")).isEmpty());
+
+    // everything starts with an empty prefix
+    QVERIFY(index.completions(QString()).size() > completions.size());
+}
+
+void UnitIndexTest::testEmptyIndex()
+{
+    const UnitIndex index;
+    QVERIFY(index.unit(QStringLiteral("km")).isEmpty());
+    QVERIFY(index.completions(QStringLiteral("k")).isEmpty());
+}
+
+void UnitIndexTest::testCacheIsWritten()
+{
+    Converter converter;
+    const UnitIndex index = UnitIndex::load(converter);
+    QVERIFY(QFile::exists(UnitIndex::cachePath()));
+
+    QStringList names;
+    QStringList units;
+    QVERIFY(UnitIndex::readCache(names, units));
+    QCOMPARE(names, index.m_names);
+    QCOMPARE(units, index.m_units);
+}
+
+/**
+ * Test if a valid cache is used instead of asking the converter
+ */
+void UnitIndexTest::testCacheIsRead()
+{
+    UnitIndex::writeCache({QStringLiteral("FOO"), QStringLiteral("FOOBAR")}, {QStringLiteral("foo"), QStringLiteral("foobar")});
+
+    Converter converter;
+    const UnitIndex index = UnitIndex::load(converter);
+    QCOMPARE(index.unit(QStringLiteral("Foo")), QStringLiteral("foo"));
+    QCOMPARE(index.completions(QStringLiteral("fo")), QStringList({QStringLiteral("foo"), QStringLiteral("foobar")}));
+    QVERIFY(index.unit(QStringLiteral("km")).isEmpty());
+}
+
+void UnitIndexTest::testUnsortedCache_data()
+{
+    QTest::addColumn<QStringList>("names");
+
+    QTest::newRow("unsorted") << QStringList({QStringLiteral("FOOBAR"), QStringLiteral("FOO")});
+    QTest::newRow("duplicate") << QStringList({QStringLiteral("FOO"), QStringLiteral("FOO")});
+}
+
+/**
+ * Test if a cache with names the index cannot be built on is ignored
+ */
+void UnitIndexTest::testUnsortedCache()
+{
+    QFETCH(QStringList, names);
+    UnitIndex::writeCache(names, {QStringLiteral("foo"), QStringLiteral("foobar")});
+
+    QStringList cachedNames;
+    QStringList cachedUnits;
+    QVERIFY(!UnitIndex::readCache(cachedNames, cachedUnits));
+
+    // built from the converter instead, and cached again
+    Converter converter;
+    const UnitIndex index = UnitIndex::load(converter);
+    QVERIFY(converter.category(LengthCategory).hasUnit(index.unit(QStringLiteral("km"))));
+    QVERIFY(UnitIndex::readCache(cachedNames, cachedUnits));
+}
+
+QTEST_GUILESS_MAIN(UnitIndexTest)
+
+#include "unitindextest.moc"
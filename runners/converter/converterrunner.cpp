@@ -17,6 +17,9 @@
 
 K_EXPORT_PLASMA_RUNNER_WITH_JSON(ConverterRunner, "plasma-runner-converter.json")
 
+// Entries kept per cache, a session rarely has more queries than that
+static const int s_cacheSize = 64;
+
 ConverterRunner::ConverterRunner(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
     : Plasma::AbstractRunner(parent, metaData, args)
 {
@@ -27,6 +30,15 @@ ConverterRunner::ConverterRunner(QObject *parent, const KPluginMetaData &metaDat
         "\"value unit [>, to, as, in] unit\". You can use the "
         "Unit converter applet to find all available units.");
     addSyntax(Plasma::RunnerSyntax(QStringLiteral(":q:"), description));
+
+    connect(this, &Plasma::AbstractRunner::prepare, this, [this]() {
+        currencyRates.refresh();
+    });
+    connect(this, &Plasma::AbstractRunner::teardown, this, &ConverterRunner::clearCaches);
+
+    resolvedUnitCache.setMaxCost(s_cacheSize);
+    resultUnitCache.setMaxCost(s_cacheSize);
+    matchCache.setMaxCost(s_cacheSize);
 }
 
 void ConverterRunner::init()
@@ -42,7 +54,7 @@ void ConverterRunner::init()
     valueRegex.optimize();
     unitSeperatorRegex.optimize();
 
-    insertCompatibleUnits();
+    compatibleUnits = UnitIndex::load(converter);
 
     actionList = {new QAction(QIcon::fromTheme(QStringLiteral("edit-copy")), i18n("Copy unit and number"), this)};
     setMinLetterCount(2);
@@ -59,21 +71,28 @@ void ConverterRunner::match(Plasma::RunnerContext &context)
     }
     const QString inputValueString = valueRegexMatch.captured(1);
 
+    const QString simplifiedQuery = context.query().simplified();
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (const QList<MatchData> *cachedMatches = matchCache.object(simplifiedQuery)) {
+            const QList<MatchData> matchData = *cachedMatches;
+            locker.unlock();
+            addMatches(context, matchData);
+            return;
+        }
+    }
+
     // Get the different units by splitting up the query with the regex
-    QStringList unitStrings = context.query().simplified().remove(valueRegex).split(unitSeperatorRegex);
+    QStringList unitStrings = QString(simplifiedQuery).remove(valueRegex).split(unitSeperatorRegex);
     if (unitStrings.isEmpty() || unitStrings.at(0).isEmpty()) {
         return;
     }
-    // Check if unit is valid, otherwise check for the value in the compatibleUnits map
-    QString inputUnitString = unitStrings.first().simplified();
-    KUnitConversion::UnitCategory inputCategory = converter.categoryForUnit(inputUnitString);
-    if (inputCategory.id() == KUnitConversion::InvalidCategory) {
-        inputUnitString = compatibleUnits.value(inputUnitString.toUpper());
-        inputCategory = converter.categoryForUnit(inputUnitString);
-        if (inputCategory.id() == KUnitConversion::InvalidCategory) {
-            return;
-        }
+    const ResolvedUnit resolvedUnit = resolveUnit(unitStrings.first().simplified());
+    if (resolvedUnit.category.id() == KUnitConversion::InvalidCategory) {
+        return;
     }
+    const QString &inputUnitString = resolvedUnit.unitString;
+    KUnitConversion::UnitCategory inputCategory = resolvedUnit.category;
 
     QString outputUnitString;
     if (unitStrings.size() == 2) {
@@ -81,7 +100,7 @@ void ConverterRunner::match(Plasma::RunnerContext &context)
     }
 
     const KUnitConversion::Unit inputUnit = inputCategory.unit(inputUnitString);
-    const QList<KUnitConversion::Unit> outputUnits = createResultUnits(outputUnitString, inputCategory);
+    const QList<KUnitConversion::Unit> outputUnits = cachedResultUnits(outputUnitString, inputCategory);
     const auto numberDataPair = getValidatedNumberValue(inputValueString);
     // Return on invalid user input
     if (!numberDataPair.first) {
@@ -89,27 +108,74 @@ void ConverterRunner::match(Plasma::RunnerContext &context)
     }
 
     const double numberValue = numberDataPair.second;
-    QList<Plasma::QueryMatch> matches;
+
+    // Converting currencies with outdated rates would download them, answer from the last rates instead
+    QSharedPointer<const CurrencySnapshot> currencySnapshot;
+    if (inputCategory.id() == KUnitConversion::CurrencyCategory && !CurrencyRates::tableIsFresh()) {
+        currencySnapshot = currencyRates.snapshot();
+        if (!currencySnapshot) {
+            // still loading them for the first time
+            return;
+        }
+        if (currencySnapshot->isFresh()) {
+            currencySnapshot.reset();
+        }
+    }
+
+    QList<MatchData> matches;
     for (const KUnitConversion::Unit &outputUnit : outputUnits) {
-        KUnitConversion::Value outputValue = inputCategory.convert(KUnitConversion::Value(numberValue, inputUnit), outputUnit);
+        KUnitConversion::Value outputValue;
+        if (currencySnapshot) {
+            double number;
+            if (currencySnapshot->convert(numberValue, inputUnit.symbol(), outputUnit.symbol(), number)) {
+                outputValue = KUnitConversion::Value(number, outputUnit);
+            }
+        } else {
+            outputValue = inputCategory.convert(KUnitConversion::Value(numberValue, inputUnit), outputUnit);
+        }
         if (!outputValue.isValid() || inputUnit == outputUnit) {
             continue;
         }
 
-        Plasma::QueryMatch match(this);
-        match.setType(Plasma::QueryMatch::HelperMatch);
-        match.setIconName(QStringLiteral("accessories-calculator"));
+        MatchData match;
         if (outputUnit.categoryId() == KUnitConversion::CurrencyCategory) {
-            match.setText(QStringLiteral("%1 (%2)").arg(outputValue.toString(0, 'f', 2), outputUnit.symbol()));
+            match.text = QStringLiteral("%1 (%2)").arg(outputValue.toString(0, 'f', 2), outputUnit.symbol());
+            if (currencySnapshot) {
+                match.subtext = currencySnapshot->description();
+            }
         } else {
-            match.setText(QStringLiteral("%1 (%2)").arg(outputValue.toString(), outputUnit.symbol()));
+            match.text = QStringLiteral("%1 (%2)").arg(outputValue.toString(), outputUnit.symbol());
         }
-        match.setData(outputValue.number());
-        match.setRelevance(1.0 - std::abs(std::log10(outputValue.number())) / 50.0);
-        match.setActions(actionList);
+        match.data = outputValue.number();
+        match.relevance = 1.0 - std::abs(std::log10(outputValue.number())) / 50.0;
         matches.append(match);
     }
 
+    // Results from outdated exchange rates are not kept, the rates may be refreshed meanwhile
+    if (!currencySnapshot) {
+        QMutexLocker locker(&cacheMutex);
+        matchCache.insert(simplifiedQuery, new QList<MatchData>(matches));
+    }
+
+    addMatches(context, matches);
+}
+
+void ConverterRunner::addMatches(Plasma::RunnerContext &context, const QList<MatchData> &matchData)
+{
+    // new matches every time, the context and the view change the ones they get
+    QList<Plasma::QueryMatch> matches;
+    matches.reserve(matchData.size());
+    for (const MatchData &data : matchData) {
+        Plasma::QueryMatch match(this);
+        match.setType(Plasma::QueryMatch::HelperMatch);
+        match.setIconName(QStringLiteral("accessories-calculator"));
+        match.setText(data.text);
+        match.setSubtext(data.subtext);
+        match.setData(data.data);
+        match.setRelevance(data.relevance);
+        match.setActions(actionList);
+        matches.append(match);
+    }
     context.addMatches(matches);
 }
 
@@ -125,6 +191,53 @@ void ConverterRunner::run(const Plasma::RunnerContext &context, const Plasma::Qu
     }
 }
 
+ConverterRunner::ResolvedUnit ConverterRunner::resolveUnit(const QString &unitString)
+{
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (const ResolvedUnit *cachedUnit = resolvedUnitCache.object(unitString)) {
+            return *cachedUnit;
+        }
+    }
+
+    // Check if unit is valid, otherwise check for the value in the compatibleUnits map
+    ResolvedUnit resolvedUnit{unitString, converter.categoryForUnit(unitString)};
+    if (resolvedUnit.category.id() == KUnitConversion::InvalidCategory) {
+        resolvedUnit.unitString = compatibleUnits.unit(unitString);
+        resolvedUnit.category = converter.categoryForUnit(resolvedUnit.unitString);
+    }
+
+    QMutexLocker locker(&cacheMutex);
+    resolvedUnitCache.insert(unitString, new ResolvedUnit(resolvedUnit));
+    return resolvedUnit;
+}
+
+QList<KUnitConversion::Unit> ConverterRunner::cachedResultUnits(const QString &outputUnitString, const KUnitConversion::UnitCategory &category)
+{
+    const QString key = QString::number(category.id()) + QLatin1Char(' ') + outputUnitString;
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (const QList<KUnitConversion::Unit> *cachedUnits = resultUnitCache.object(key)) {
+            return *cachedUnits;
+        }
+    }
+
+    QString unitString = outputUnitString;
+    const QList<KUnitConversion::Unit> units = createResultUnits(unitString, category);
+
+    QMutexLocker locker(&cacheMutex);
+    resultUnitCache.insert(key, new QList<KUnitConversion::Unit>(units));
+    return units;
+}
+
+void ConverterRunner::clearCaches()
+{
+    QMutexLocker locker(&cacheMutex);
+    resolvedUnitCache.clear();
+    resultUnitCache.clear();
+    matchCache.clear();
+}
+
 QPair<bool, double> ConverterRunner::stringToDouble(const QStringRef &value)
 {
     bool ok;
@@ -172,13 +285,11 @@ QList<KUnitConversion::Unit> ConverterRunner::createResultUnits(QString &outputU
             units.append(outputUnit);
         } else {
             // Autocompletion for the target units
-            outputUnitString = outputUnitString.toUpper();
-            for (auto it = compatibleUnits.constBegin(); it != compatibleUnits.constEnd(); it++) {
-                if (it.key().startsWith(outputUnitString)) {
-                    outputUnit = category.unit(it.value());
-                    if (!units.contains(outputUnit)) {
-                        units << outputUnit;
-                    }
+            const QStringList completions = compatibleUnits.completions(outputUnitString);
+            for (const QString &completion : completions) {
+                outputUnit = category.unit(completion);
+                if (!units.contains(outputUnit)) {
+                    units << outputUnit;
                 }
             }
         }
@@ -197,33 +308,4 @@ QList<KUnitConversion::Unit> ConverterRunner::createResultUnits(QString &outputU
 
     return units;
 }
-void ConverterRunner::insertCompatibleUnits()
-{
-    // Add all currency symbols to the map, if their ISO code is supported by backend
-    const QList<QLocale> allLocales = QLocale::matchingLocales(QLocale::AnyLanguage, QLocale::AnyScript, QLocale::AnyCountry);
-    KUnitConversion::UnitCategory currencyCategory = converter.category(QStringLiteral("Currency"));
-    const QStringList availableISOCodes = currencyCategory.allUnits();
-    QRegularExpression hasCurrencyRegex = QRegularExpression(QStringLiteral("\\p{Sc}"));
-    hasCurrencyRegex.optimize();
-    for (const auto &currencyLocale : allLocales) {
-        const QString symbol = currencyLocale.currencySymbol(QLocale::CurrencySymbol);
-        const QString isoCode = currencyLocale.currencySymbol(QLocale::CurrencyIsoCode);
-
-        if (isoCode.isEmpty() || !symbol.contains(hasCurrencyRegex)) {
-            continue;
-        }
-        if (availableISOCodes.contains(isoCode)) {
-            compatibleUnits.insert(symbol.toUpper(), isoCode);
-        }
-    }
-
-    // Add all units as uppercase in the map
-    const auto categories = converter.categories();
-    for (const auto &category : categories) {
-        const auto allUnits = category.allUnits();
-        for (const auto &unit : allUnits) {
-            compatibleUnits.insert(unit.toUpper(), unit);
-        }
-    }
-}
 #include "converterrunner.moc"
@@ -12,9 +12,14 @@
 #include <KUnitConversion/Converter>
 #include <KUnitConversion/UnitCategory>
 #include <QAction>
+#include <QCache>
 #include <QLocale>
+#include <QMutex>
 #include <QRegularExpression>
 
+#include "currencyrates.h"
+#include "unitindex.h"
+
 /**
  * This class converts values to different units.
  */
@@ -25,22 +30,49 @@ class ConverterRunner : public Plasma::AbstractRunner
 public:
     ConverterRunner(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args);
     void init() override;
-    void insertCompatibleUnits();
     ~ConverterRunner() override;
 
     void match(Plasma::RunnerContext &context) override;
     void run(const Plasma::RunnerContext &context, const Plasma::QueryMatch &match) override;
 
 private:
+    friend class ConverterRunnerTest;
+
     KUnitConversion::Converter converter;
     const QLocale locale;
     QRegularExpression valueRegex;
     QRegularExpression unitSeperatorRegex;
     /** To convert currency symbols back to ISO string and handle case sensitive units */
-    QMap<QString, QString> compatibleUnits;
+    UnitIndex compatibleUnits;
+    CurrencyRates currencyRates;
 
     QList<QAction *> actionList;
 
+    /** What has been worked out during the current match session, cleared on teardown */
+    struct ResolvedUnit {
+        QString unitString;
+        KUnitConversion::UnitCategory category;
+    };
+    /** What a match is made of, matches themselves are shared with whoever they are handed to */
+    struct MatchData {
+        QString text;
+        QString subtext;
+        QVariant data;
+        qreal relevance;
+    };
+    QMutex cacheMutex;
+    /** By the unit typed, also for units which do not exist */
+    QCache<QString, ResolvedUnit> resolvedUnitCache;
+    /** By category and target unit typed */
+    QCache<QString, QList<KUnitConversion::Unit>> resultUnitCache;
+    /** By the simplified query */
+    QCache<QString, QList<MatchData>> matchCache;
+
+    ResolvedUnit resolveUnit(const QString &unitString);
+    QList<KUnitConversion::Unit> cachedResultUnits(const QString &outputUnitString, const KUnitConversion::UnitCategory &category);
+    void clearCaches();
+    void addMatches(Plasma::RunnerContext &context, const QList<MatchData> &matchData);
+
     QPair<bool, double> stringToDouble(const QStringRef &value);
     QPair<bool, double> getValidatedNumberValue(const QString &value);
     QList<KUnitConversion::Unit> createResultUnits(QString &outputUnitString, const KUnitConversion::UnitCategory &category);
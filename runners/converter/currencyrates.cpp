@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "currencyrates.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+#include <KLocalizedString>
+#include <KUnitConversion/Converter>
+#include <KUnitConversion/UnitCategory>
+
+namespace
+{
+// KUnitConversion downloads the rates once they are older than a day,
+// leave a margin so converting never gets there
+constexpr qint64 s_freshSecs = 23 * 60 * 60;
+// don't try again right away when downloading has failed, e.g. when offline
+constexpr qint64 s_retryMSecs = 10 * 60 * 1000;
+
+QDateTime tableModified()
+{
+    // where KUnitConversion keeps the downloaded rates
+    const QString table = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/libkunitconversion/currency.xml");
+    return QFileInfo(table).lastModified();
+}
+
+QSharedPointer<const CurrencySnapshot> loadSnapshot()
+{
+    KUnitConversion::Converter converter;
+    KUnitConversion::UnitCategory category = converter.category(KUnitConversion::CurrencyCategory);
+    const KUnitConversion::Unit euro = category.unit(QStringLiteral("EUR"));
+
+    // this is what downloads the rates if needed
+    category.convert(KUnitConversion::Value(1.0, euro), euro);
+
+    QSharedPointer<CurrencySnapshot> snapshot(new CurrencySnapshot);
+    snapshot->updated = tableModified();
+    const QList<KUnitConversion::Unit> units = category.units();
+    for (const KUnitConversion::Unit &unit : units) {
+        const KUnitConversion::Value value = category.convert(KUnitConversion::Value(1.0, euro), unit);
+        if (value.isValid()) {
+            snapshot->perEuro.insert(unit.symbol(), value.number());
+        }
+    }
+    return snapshot;
+}
+}
+
+struct CurrencyRates::State {
+    QMutex mutex;
+    QSharedPointer<const CurrencySnapshot> snapshot;
+    bool refreshing = false;
+    QElapsedTimer lastAttempt;
+};
+
+bool CurrencySnapshot::isFresh() const
+{
+    return updated.isValid() && updated.secsTo(QDateTime::currentDateTime()) < s_freshSecs;
+}
+
+bool CurrencySnapshot::convert(double value, const QString &from, const QString &to, double &result) const
+{
+    const double fromPerEuro = perEuro.value(from);
+    const double toPerEuro = perEuro.value(to);
+    if (qFuzzyIsNull(fromPerEuro) || qFuzzyIsNull(toPerEuro)) {
+        return false;
+    }
+    result = value / fromPerEuro * toPerEuro;
+    return true;
+}
+
+QString CurrencySnapshot::description() const
+{
+    if (!updated.isValid()) {
+        return i18n("Exchange rates may be out of date");
+    }
+    return i18n("Exchange rates of %1", QLocale().toString(updated, QLocale::ShortFormat));
+}
+
+CurrencyRates::CurrencyRates()
+    : d(std::make_shared<State>())
+{
+}
+
+void CurrencyRates::refresh()
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        if (d->refreshing || (d->snapshot && d->snapshot->isFresh())) {
+            return;
+        }
+        if (d->lastAttempt.isValid() && !d->lastAttempt.hasExpired(s_retryMSecs)) {
+            return;
+        }
+        d->refreshing = true;
+        d->lastAttempt.start();
+    }
+
+    std::shared_ptr<State> state = d;
+    QThreadPool::globalInstance()->start([state]() {
+        const QSharedPointer<const CurrencySnapshot> snapshot = loadSnapshot();
+
+        QMutexLocker locker(&state->mutex);
+        state->snapshot = snapshot;
+        state->refreshing = false;
+    });
+}
+
+QSharedPointer<const CurrencySnapshot> CurrencyRates::snapshot() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->snapshot;
+}
+
+bool CurrencyRates::tableIsFresh()
+{
+    const QDateTime modified = tableModified();
+    return modified.isValid() && modified.secsTo(QDateTime::currentDateTime()) < s_freshSecs;
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef CURRENCYRATES_H
+#define CURRENCYRATES_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+
+#include <memory>
+
+/**
+ * The exchange rates as they were when they have last been loaded.
+ */
+class CurrencySnapshot
+{
+public:
+    /**
+     * Whether the rates are recent enough for KUnitConversion not to
+     * download them again when converting
+     */
+    bool isFresh() const;
+
+    /**
+     * Converts @p value from the currency @p from to @p to, which are
+     * ISO codes. Returns false if either is unknown.
+     */
+    bool convert(double value, const QString &from, const QString &to, double &result) const;
+
+    /**
+     * Returns what to tell about results converted with these rates, which
+     * are not fresh
+     */
+    QString description() const;
+
+    // when the rates have been downloaded
+    QDateTime updated;
+    // units of every currency for one euro
+    QHash<QString, double> perEuro;
+};
+
+/**
+ * Keeps the exchange rates of KUnitConversion up to date in the background.
+ *
+ * Converting currencies downloads the rates when they are older than a day,
+ * which would stall the query doing so. Instead the rates are refreshed in
+ * the thread pool when a match session starts, and queries meanwhile answer
+ * from the snapshot taken after the last refresh.
+ */
+class CurrencyRates
+{
+public:
+    CurrencyRates();
+
+    /**
+     * Starts refreshing the rates unless they are fresh or being refreshed
+     * already. Never blocks.
+     */
+    void refresh();
+
+    /**
+     * Returns the rates of the last refresh, or null before the first one
+     * has been completed
+     */
+    QSharedPointer<const CurrencySnapshot> snapshot() const;
+
+    /**
+     * Whether the rates KUnitConversion has on disk are recent enough for
+     * it not to download them again when converting
+     */
+    static bool tableIsFresh();
+
+private:
+    struct State;
+    // shared with the refresh, which may outlive the runner
+    std::shared_ptr<State> d;
+};
+
+#endif
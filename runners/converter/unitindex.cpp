@@ -0,0 +1,220 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "unitindex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMap>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <KLocalizedString>
+#include <KUnitConversion/Converter>
+#include <KUnitConversion/UnitCategory>
+#include <kunitconversion_version.h>
+
+#include <algorithm>
+
+namespace
+{
+// "UnIx", followed by the version of the format
+constexpr quint32 s_magic = 0x556e4978;
+constexpr quint8 s_version = 1;
+}
+
+UnitIndex UnitIndex::load(const KUnitConversion::Converter &converter)
+{
+    QStringList names;
+    QStringList units;
+    if (readCache(names, units)) {
+        return UnitIndex(names, units);
+    }
+
+    // a later name replaces an earlier one, so unit names win over currency symbols
+    QMap<QString, QString> compatibleUnits;
+
+    // Add all currency symbols to the map, if their ISO code is supported by backend
+    const QList<QLocale> allLocales = QLocale::matchingLocales(QLocale::AnyLanguage, QLocale::AnyScript, QLocale::AnyCountry);
+    const KUnitConversion::UnitCategory currencyCategory = converter.category(QStringLiteral("Currency"));
+    const QStringList availableISOCodes = currencyCategory.allUnits();
+    QRegularExpression hasCurrencyRegex = QRegularExpression(QStringLiteral("\\p{Sc}"));
+    hasCurrencyRegex.optimize();
+    for (const auto &currencyLocale : allLocales) {
+        const QString symbol = currencyLocale.currencySymbol(QLocale::CurrencySymbol);
+        const QString isoCode = currencyLocale.currencySymbol(QLocale::CurrencyIsoCode);
+
+        if (isoCode.isEmpty() || !symbol.contains(hasCurrencyRegex)) {
+            continue;
+        }
+        if (availableISOCodes.contains(isoCode)) {
+            compatibleUnits.insert(symbol.toUpper(), isoCode);
+        }
+    }
+
+    // Add all units as uppercase in the map
+    const auto categories = converter.categories();
+    for (const auto &category : categories) {
+        const auto allUnits = category.allUnits();
+        for (const auto &unit : allUnits) {
+            compatibleUnits.insert(unit.toUpper(), unit);
+        }
+    }
+
+    names = compatibleUnits.keys();
+    units = compatibleUnits.values();
+    writeCache(names, units);
+
+    return UnitIndex(names, units);
+}
+
+UnitIndex::UnitIndex(const QStringList &names, const QStringList &units)
+    : m_names(names)
+    , m_units(units)
+{
+    m_nodes.append(Node());
+    buildNode(0, 0, m_names.size(), 0);
+    m_nodes.squeeze();
+}
+
+void UnitIndex::buildNode(int node, int firstName, int lastName, int depth)
+{
+    m_nodes[node].firstName = firstName;
+    m_nodes[node].lastName = lastName;
+
+    // the name ending here, if any, sorts before the longer ones
+    int name = firstName;
+    if (name < lastName && m_names.at(name).size() == depth) {
+        ++name;
+    }
+
+    // the names below the node, grouped by their next character
+    QVector<QPair<int, int>> groups;
+    while (name < lastName) {
+        const QChar character = m_names.at(name).at(depth);
+        const int groupStart = name;
+        while (name < lastName && m_names.at(name).at(depth) == character) {
+            ++name;
+        }
+        groups.append({groupStart, name});
+    }
+
+    const int firstChild = m_nodes.size();
+    m_nodes[node].firstChild = firstChild;
+    m_nodes[node].childCount = groups.size();
+    m_nodes.resize(firstChild + groups.size());
+
+    for (int i = 0; i < groups.size(); ++i) {
+        m_nodes[firstChild + i].character = m_names.at(groups.at(i).first).at(depth);
+        buildNode(firstChild + i, groups.at(i).first, groups.at(i).second, depth + 1);
+    }
+}
+
+int UnitIndex::findNode(const QString &prefix) const
+{
+    if (m_nodes.isEmpty()) {
+        return -1;
+    }
+
+    int node = 0;
+    for (const QChar character : prefix) {
+        const auto first = m_nodes.cbegin() + m_nodes.at(node).firstChild;
+        const auto last = first + m_nodes.at(node).childCount;
+        const auto child = std::lower_bound(first, last, character, [](const Node &node, QChar character) {
+            return node.character < character;
+        });
+        if (child == last || child->character != character) {
+            return -1;
+        }
+        node = child - m_nodes.cbegin();
+    }
+    return node;
+}
+
+QString UnitIndex::unit(const QString &name) const
+{
+    const QString key = name.toUpper();
+    const int node = findNode(key);
+    if (node == -1) {
+        return QString();
+    }
+
+    const int firstName = m_nodes.at(node).firstName;
+    if (firstName < m_nodes.at(node).lastName && m_names.at(firstName).size() == key.size()) {
+        return m_units.at(firstName);
+    }
+    return QString();
+}
+
+QStringList UnitIndex::completions(const QString &prefix) const
+{
+    const int node = findNode(prefix.toUpper());
+    if (node == -1) {
+        return QStringList();
+    }
+    return m_units.mid(m_nodes.at(node).firstName, m_nodes.at(node).lastName - m_nodes.at(node).firstName);
+}
+
+QString UnitIndex::cachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/krunner_converter_units");
+}
+
+QString UnitIndex::cacheKey()
+{
+    // the unit names are translated, and the currency symbols come with the Qt in use
+    return QStringLiteral(KUNITCONVERSION_VERSION_STRING "/") + QLatin1String(qVersion()) + QLatin1Char('/')
+        + KLocalizedString::languages().join(QLatin1Char(':'));
+}
+
+bool UnitIndex::readCache(QStringList &names, QStringList &units)
+{
+    QFile file(cachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic;
+    quint8 version;
+    QString key;
+    stream >> magic >> version;
+    if (magic != s_magic || version != s_version) {
+        return false;
+    }
+    stream >> key;
+    if (key != cacheKey()) {
+        return false;
+    }
+    stream >> names >> units;
+    if (stream.status() != QDataStream::Ok || names.size() != units.size() || names.isEmpty()) {
+        return false;
+    }
+
+    // the trie is built on names in order, a damaged cache must not break it
+    return std::is_sorted(names.cbegin(), names.cend()) && std::adjacent_find(names.cbegin(), names.cend()) == names.cend();
+}
+
+void UnitIndex::writeCache(const QStringList &names, const QStringList &units)
+{
+    QDir().mkpath(QFileInfo(cachePath()).path());
+
+    QSaveFile file(cachePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << s_magic << s_version << cacheKey() << names << units;
+    file.commit();
+}
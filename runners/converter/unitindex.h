@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef UNITINDEX_H
+#define UNITINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace KUnitConversion
+{
+class Converter;
+}
+
+/**
+ * Maps the names and symbols of all units, and the symbols of the currencies,
+ * to the units they stand for, case insensitively. It is a prefix trie, so
+ * completing a name takes time proportional to the length of what has been
+ * typed and the number of units found, rather than to all units there are.
+ *
+ * Enumerating the currency symbols takes going through all locales, which is
+ * why the names are cached on disk, for as long as neither KUnitConversion
+ * nor the language changes.
+ */
+class UnitIndex
+{
+public:
+    UnitIndex() = default;
+
+    /**
+     * Returns the index for the units of @p converter, from the cache if
+     * it is still valid
+     */
+    static UnitIndex load(const KUnitConversion::Converter &converter);
+
+    /**
+     * Returns the unit named @p name, or an empty string if there is none
+     */
+    QString unit(const QString &name) const;
+
+    /**
+     * Returns the units with a name starting with @p prefix, in the order
+     * of the names. A unit with several such names is returned once per name.
+     */
+    QStringList completions(const QString &prefix) const;
+
+private:
+    friend class UnitIndexTest;
+
+    struct Node {
+        QChar character;
+        // children are stored next to each other, sorted by character
+        int firstChild = 0;
+        int childCount = 0;
+        // the names below the node are names [firstName, lastName)
+        int firstName = 0;
+        int lastName = 0;
+    };
+
+    /**
+     * @param names the upper case names, sorted and unique
+     * @param units the unit of each name
+     */
+    UnitIndex(const QStringList &names, const QStringList &units);
+
+    void buildNode(int node, int firstName, int lastName, int depth);
+    int findNode(const QString &prefix) const;
+
+    static QString cachePath();
+    static QString cacheKey();
+    static bool readCache(QStringList &names, QStringList &units);
+    static void writeCache(const QStringList &names, const QStringList &units);
+
+    QStringList m_names;
+    QStringList m_units;
+    QVector<Node> m_nodes;
+};
+
+#endif
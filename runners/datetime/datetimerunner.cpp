@@ -7,6 +7,7 @@
  */
 
 #include "datetimerunner.h"
+#include "timezoneindex.h"
 
 #include <QIcon>
 #include <QLocale>
@@ -62,34 +63,13 @@ void DateTimeRunner::match(Plasma::RunnerContext &context)
 QHash<QString, QDateTime> DateTimeRunner::datetime(const QStringRef &tz)
 {
     QHash<QString, QDateTime> ret;
-    //
-    // KTimeZone gives us the actual timezone names such as "Asia/Kolkatta" and does
-    // not give us country info. QTimeZone does not give us the actual timezone name
-    // This is why we are using both for now.
-    //
-    const QList<QByteArray> timeZoneIds = QTimeZone::availableTimeZoneIds();
-    for (const QByteArray &zoneId : timeZoneIds) {
-        QTimeZone timeZone(zoneId);
 
-        const QString zoneName = QString::fromUtf8(zoneId);
-        if (zoneName.contains(tz, Qt::CaseInsensitive)) {
-            ret[zoneName] = QDateTime::currentDateTimeUtc().toTimeZone(timeZone);
-            continue;
-        }
-
-        const QString country = QLocale::countryToString(timeZone.country());
-        if (country.contains(tz, Qt::CaseInsensitive)) {
-            ret[country] = QDateTime::currentDateTimeUtc().toTimeZone(timeZone);
-            continue;
-        }
-
-        // FIXME: This only includes the current abbreviation and not old abbreviation or
-        // other possible names.
-        // Eg - depending on the current date, only CET or CEST will work
-        const QString abbr = timeZone.abbreviation(QDateTime::currentDateTime());
-        if (abbr.contains(tz, Qt::CaseInsensitive)) {
-            ret[abbr] = QDateTime::currentDateTimeUtc().toTimeZone(timeZone);
-            continue;
+    // only the zones found are converted, looking them up needs no QTimeZone
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const QVector<TimeZoneIndex::Match> matches = TimeZoneIndex::instance().find(tz);
+    for (const TimeZoneIndex::Match &match : matches) {
+        if (!ret.contains(match.label)) {
+            ret[match.label] = now.toTimeZone(QTimeZone(match.zoneId));
         }
     }
 
@@ -0,0 +1,122 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#include "timezoneindex.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QLocale>
+#include <QSet>
+#include <QTimeZone>
+
+#include <algorithm>
+
+Q_GLOBAL_STATIC(TimeZoneIndex, s_index)
+
+const TimeZoneIndex &TimeZoneIndex::instance()
+{
+    return *s_index();
+}
+
+TimeZoneIndex::TimeZoneIndex()
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    // Abbreviations from before are mostly local mean times, which nobody looks for
+    const QDateTime historyStart = QDateTime::fromMSecsSinceEpoch(0, Qt::UTC);
+    const QDateTime historyEnd = now.addYears(1);
+
+    const QList<QByteArray> timeZoneIds = QTimeZone::availableTimeZoneIds();
+    m_zoneIds.reserve(timeZoneIds.size());
+
+    for (const QByteArray &zoneId : timeZoneIds) {
+        const QTimeZone timeZone(zoneId);
+        if (!timeZone.isValid()) {
+            continue;
+        }
+
+        const int zone = m_zoneIds.size();
+        m_zoneIds.append(zoneId);
+
+        const QString zoneName = QString::fromUtf8(zoneId);
+        addEntry(zoneName, ZoneId, zone);
+
+        // "America/Argentina/Buenos_Aires" can also be found by "Buenos Aires"
+        const QStringList components = zoneName.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        for (int i = 1; i < components.size(); ++i) {
+            if (components.at(i).contains(QLatin1Char('_'))) {
+                addEntry(QString(components.at(i)).replace(QLatin1Char('_'), QLatin1Char(' ')), ZoneId, zone);
+            }
+        }
+
+        if (timeZone.country() != QLocale::AnyCountry) {
+            addEntry(QLocale::countryToString(timeZone.country()), Country, zone);
+        }
+
+        QSet<QString> abbreviations;
+        abbreviations.insert(timeZone.abbreviation(now));
+        const QTimeZone::OffsetDataList transitions = timeZone.transitions(historyStart, historyEnd);
+        for (const QTimeZone::OffsetData &transition : transitions) {
+            abbreviations.insert(transition.abbreviation);
+        }
+        for (const QString &abbreviation : qAsConst(abbreviations)) {
+            if (!abbreviation.isEmpty()) {
+                addEntry(abbreviation, Abbreviation, zone);
+            }
+        }
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.key < b.key;
+    });
+    m_entries.squeeze();
+}
+
+void TimeZoneIndex::addEntry(const QString &label, Kind kind, int zone)
+{
+    m_entries.append({label.toCaseFolded(), label, kind, zone});
+}
+
+QVector<TimeZoneIndex::Match> TimeZoneIndex::find(const QStringRef &term, MatchMode mode) const
+{
+    const QString key = term.toString().toCaseFolded();
+
+    // the best entry found for every zone
+    QHash<int, const Entry *> found;
+    auto consider = [&found](const Entry &entry) {
+        auto it = found.find(entry.zone);
+        if (it == found.end()) {
+            found.insert(entry.zone, &entry);
+        } else if (entry.kind < (*it)->kind) {
+            *it = &entry;
+        }
+    };
+
+    if (mode == Prefix) {
+        auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key, [](const Entry &entry, const QString &key) {
+            return entry.key < key;
+        });
+        for (; it != m_entries.cend() && it->key.startsWith(key); ++it) {
+            consider(*it);
+        }
+    } else {
+        for (const Entry &entry : m_entries) {
+            if (entry.key.contains(key)) {
+                consider(entry);
+            }
+        }
+    }
+
+    QVector<Match> matches;
+    matches.reserve(found.size());
+    for (auto it = found.constBegin(); it != found.constEnd(); ++it) {
+        const Entry *entry = it.value();
+        const QByteArray &zoneId = m_zoneIds.at(entry->zone);
+        // matches by city are still shown with the id of their zone
+        const QString label = entry->kind == ZoneId ? QString::fromUtf8(zoneId) : entry->label;
+        matches.append({zoneId, entry->kind, label});
+    }
+    return matches;
+}
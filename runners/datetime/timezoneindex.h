@@ -0,0 +1,73 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#ifndef TIMEZONEINDEX_H
+#define TIMEZONEINDEX_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+/**
+ * The names time zones can be looked up by: their ids, the cities in them,
+ * the names of their countries and the abbreviations they have used.
+ *
+ * The index is built once, on first use, and never changes afterwards, so
+ * it can be shared by all the threads running queries without locking.
+ */
+class TimeZoneIndex
+{
+public:
+    enum Kind {
+        ZoneId = 0, ///< e.g. "America/New_York", or the city "New York"
+        Country, ///< e.g. "United States"
+        Abbreviation, ///< e.g. "EST" or "EDT"
+    };
+
+    enum MatchMode {
+        Substring,
+        Prefix,
+    };
+
+    struct Match {
+        QByteArray zoneId;
+        Kind kind;
+        // what the zone has been found by, the id for ZoneId matches
+        QString label;
+    };
+
+    /**
+     * Returns the index, building it if it does not exist yet
+     */
+    static const TimeZoneIndex &instance();
+
+    TimeZoneIndex();
+
+    /**
+     * Returns the zones with a name matching @p term, case insensitively,
+     * at most one per zone. A zone found by more than one name is returned
+     * for the kind of name coming first in Kind.
+     */
+    QVector<Match> find(const QStringRef &term, MatchMode mode = Substring) const;
+
+private:
+    struct Entry {
+        // the name case folded, which is what is searched
+        QString key;
+        QString label;
+        Kind kind;
+        int zone;
+    };
+
+    void addEntry(const QString &label, Kind kind, int zone);
+
+    QVector<QByteArray> m_zoneIds;
+    // sorted by key, for prefix lookups
+    QVector<Entry> m_entries;
+};
+
+#endif
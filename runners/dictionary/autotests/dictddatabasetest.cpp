@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "dictddatabase.h"
+#include "dictddatafile.h"
+
+class DictdDatabaseTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testDefinitions_data();
+    void testDefinitions();
+    void testMultipleDefinitions_data();
+    void testMultipleDefinitions();
+    void testUnknownWord_data();
+    void testUnknownWord();
+    void testCompressedRead();
+    void testLookup();
+    void testFind();
+};
+
+void DictdDatabaseTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void DictdDatabaseTest::testDefinitions_data()
+{
+    QTest::addColumn<QString>("indexPath");
+    QTest::addColumn<QString>("word");
+    QTest::addColumn<QString>("headword");
+
+    for (const char *database : {"test", "compressed"}) {
+        const QString indexPath = QStringLiteral(FIXTURES_DIR "/") + QLatin1String(database) + QLatin1String(".index");
+        QTest::addRow("%s: exact", database) << indexPath << QStringLiteral("dog") << QStringLiteral("dog");
+        QTest::addRow("%s: case insensitive", database) << indexPath << QStringLiteral("Zebra") << QStringLiteral("zebra");
+        QTest::addRow("%s: punctuation", database) << indexPath << QStringLiteral("half-life") << QStringLiteral("half-life");
+        QTest::addRow("%s: spaces", database) << indexPath << QStringLiteral("hot dog") << QStringLiteral("hot dog");
+        QTest::addRow("%s: first entry", database) << indexPath << QStringLiteral("00-database-short") << QStringLiteral("00-database-short");
+    }
+}
+
+void DictdDatabaseTest::testDefinitions()
+{
+    QFETCH(QString, indexPath);
+    QFETCH(QString, word);
+    QFETCH(QString, headword);
+
+    const DictdDatabase database(indexPath);
+    QVERIFY(database.isValid());
+
+    const QStringList definitions = database.definitions(word);
+    QCOMPARE(definitions.size(), 1);
+    QCOMPARE(definitions.first().section(QLatin1Char('\n'), 0, 0), headword);
+}
+
+void DictdDatabaseTest::testMultipleDefinitions_data()
+{
+    QTest::addColumn<QString>("indexPath");
+
+    QTest::newRow("plain") << QStringLiteral(FIXTURES_DIR "/test.index");
+    QTest::newRow("dictzip") << QStringLiteral(FIXTURES_DIR "/compressed.index");
+}
+
+void DictdDatabaseTest::testMultipleDefinitions()
+{
+    QFETCH(QString, indexPath);
+
+    const DictdDatabase database(indexPath);
+    const QStringList definitions = database.definitions(QStringLiteral("cat"));
+    QCOMPARE(definitions.size(), 2);
+    QVERIFY(definitions.at(0).startsWith(QLatin1String("cat\n    n 1: feline mammal")));
+    QVERIFY(definitions.at(1).startsWith(QLatin1String("CAT\n    n 1: a method")));
+}
+
+void DictdDatabaseTest::testUnknownWord_data()
+{
+    QTest::addColumn<QString>("word");
+
+    QTest::newRow("before all") << QStringLiteral("");
+    QTest::newRow("between") << QStringLiteral("cow");
+    QTest::newRow("prefix") << QStringLiteral("ca");
+    QTest::newRow("after all") << QStringLiteral("zzz");
+}
+
+void DictdDatabaseTest::testUnknownWord()
+{
+    QFETCH(QString, word);
+
+    const DictdDatabase database(QStringLiteral(FIXTURES_DIR "/compressed.index"));
+    QVERIFY(database.definitions(word).isEmpty());
+    QVERIFY(database.lookup(word).isEmpty());
+}
+
+void DictdDatabaseTest::testCompressedRead()
+{
+    QFile plainFile(QStringLiteral(FIXTURES_DIR "/test.dict"));
+    QVERIFY(plainFile.open(QIODevice::ReadOnly));
+    const QByteArray plain = plainFile.readAll();
+
+    // the fixture has chunks of 64 bytes, so this covers reads within and across chunks
+    const DictdDataFile compressed(QStringLiteral(FIXTURES_DIR "/compressed.dict.dz"));
+    QVERIFY(compressed.isValid());
+    for (int offset : {0, 10, 63, 64, 100, 600}) {
+        for (int length : {1, 30, 64, 200}) {
+            QCOMPARE(compressed.read(offset, length), plain.mid(offset, length));
+        }
+    }
+    QCOMPARE(compressed.read(0, plain.size()), plain);
+    QVERIFY(compressed.read(plain.size(), 10).isEmpty());
+
+    // lengths and offsets of a broken index are not taken for granted
+    QCOMPARE(compressed.read(600, qint64(1) << 40), plain.mid(600));
+    QVERIFY(compressed.read(qint64(1) << 40, 10).isEmpty());
+}
+
+void DictdDatabaseTest::testLookup()
+{
+    const DictdDatabase database(QStringLiteral(FIXTURES_DIR "/test.index"));
+    const QString html = database.lookup(QStringLiteral("dog")).value(QStringLiteral("text")).toString();
+
+    // the shape the dict data engine gives definitions in
+    QVERIFY(html.startsWith(QLatin1String("<dl>\n<dt><b>dog</b></dt>\n<dd>")));
+    QVERIFY(html.contains(QLatin1String("\n<br>\n<b>    n 1:</b> a member of the genus Canis [syn: <a href=\"domestic dog\">domestic dog</a>]")));
+    QVERIFY(html.endsWith(QLatin1String("</dd></dl>")));
+}
+
+void DictdDatabaseTest::testFind()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/dictd");
+    QVERIFY(QDir().mkpath(dir));
+    for (const char *file : {"compressed.index", "compressed.dict.dz"}) {
+        QFile::remove(dir + QLatin1Char('/') + QLatin1String(file));
+        QVERIFY(QFile::copy(QStringLiteral(FIXTURES_DIR "/") + QLatin1String(file), dir + QLatin1Char('/') + QLatin1String(file)));
+    }
+
+    const auto database = DictdDatabase::find(QStringLiteral("compressed"));
+    QVERIFY(database);
+    QCOMPARE(database->definitions(QStringLiteral("zebra")).size(), 1);
+    QCOMPARE(DictdDatabase::find(QStringLiteral("compressed")), database);
+
+    QVERIFY(!DictdDatabase::find(QStringLiteral("not-installed")));
+
+    // a database installed meanwhile is found
+    QVERIFY(!DictdDatabase::find(QStringLiteral("test")));
+    for (const char *file : {"test.index", "test.dict"}) {
+        QVERIFY(QFile::copy(QStringLiteral(FIXTURES_DIR "/") + QLatin1String(file), dir + QLatin1Char('/') + QLatin1String(file)));
+    }
+    QVERIFY(DictdDatabase::find(QStringLiteral("test")));
+
+    QDir(dir).removeRecursively();
+}
+
+QTEST_GUILESS_MAIN(DictdDatabaseTest)
+
+#include "dictddatabasetest.moc"
@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include <KRunner/RunnerContext>
+#include <Plasma/DataContainer>
+#include <Plasma/DataEngine>
+#include <QHash>
+#include <QStandardPaths>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <memory>
+
+#include "dictionarymatchengine.h"
+
+/**
+ * Stands in for the dict engine, answers every word with a definition of its
+ * own after a moment, or only when asked to.
+ */
+class FakeDictEngine : public Plasma::DataEngine
+{
+    Q_OBJECT
+public:
+    FakeDictEngine()
+        : Plasma::DataEngine(nullptr, QVariantList())
+    {
+    }
+
+    static QString definitionOf(const QString &word)
+    {
+        return QStringLiteral("definition of ") + word;
+    }
+
+    void answer(const QString &word)
+    {
+        setData(word, QStringLiteral("text"), definitionOf(word));
+    }
+
+    bool isConnected(const QString &word, QObject *visualization)
+    {
+        const Plasma::DataContainer *container = containerForSource(word);
+        return container && container->visualizationIsConnected(visualization);
+    }
+
+    QHash<QString, int> requests;
+    bool answerRightAway = true;
+
+protected:
+    bool sourceRequestEvent(const QString &word) override
+    {
+        ++requests[word];
+        // what the dict engine has before the server answered
+        setData(word, QStringLiteral("status"), QStringLiteral("pending"));
+        if (answerRightAway) {
+            QTimer::singleShot(200, this, [this, word]() {
+                answer(word);
+            });
+        }
+        return true;
+    }
+};
+
+class DictionaryMatchEngineTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testDifferentWords();
+    void testSameWord();
+    void testLastWaiterDisconnects();
+
+private:
+    /** Looks @p word up in a thread of its own, like the runner does */
+    QThread *lookup(const QString &word, QString *definition);
+    bool waitForLookups();
+
+    std::unique_ptr<FakeDictEngine> m_dictEngine;
+    std::unique_ptr<DictionaryMatchEngine> m_matchEngine;
+    QList<QThread *> m_threads;
+};
+
+void DictionaryMatchEngineTest::initTestCase()
+{
+    // keep a dictionary installed for the user out of it
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void DictionaryMatchEngineTest::init()
+{
+    m_dictEngine.reset(new FakeDictEngine);
+    m_matchEngine.reset(new DictionaryMatchEngine(m_dictEngine.get()));
+}
+
+void DictionaryMatchEngineTest::cleanup()
+{
+    waitForLookups();
+    qDeleteAll(m_threads);
+    m_threads.clear();
+    m_matchEngine.reset();
+    m_dictEngine.reset();
+}
+
+QThread *DictionaryMatchEngineTest::lookup(const QString &word, QString *definition)
+{
+    DictionaryMatchEngine *matchEngine = m_matchEngine.get();
+    QThread *thread = QThread::create([matchEngine, word, definition]() {
+        Plasma::RunnerContext context;
+        *definition = matchEngine->lookupWord(word, context);
+    });
+    m_threads.append(thread);
+    thread->start();
+    return thread;
+}
+
+bool DictionaryMatchEngineTest::waitForLookups()
+{
+    // the engine answers in this thread, keep its events going
+    return QTest::qWaitFor(
+        [this]() {
+            return std::all_of(m_threads.cbegin(), m_threads.cend(), [](QThread *thread) {
+                return thread->isFinished();
+            });
+        },
+        10000);
+}
+
+void DictionaryMatchEngineTest::testDifferentWords()
+{
+    const QStringList words = {QStringLiteral("plugh"), QStringLiteral("xyzzy"), QStringLiteral("frotz")};
+    QVector<QString> definitions(words.size());
+    for (int i = 0; i < words.size(); ++i) {
+        lookup(words.at(i), &definitions[i]);
+    }
+    QVERIFY(waitForLookups());
+
+    for (int i = 0; i < words.size(); ++i) {
+        QCOMPARE(definitions.at(i), FakeDictEngine::definitionOf(words.at(i)));
+        QCOMPARE(m_dictEngine->requests.value(words.at(i)), 1);
+    }
+}
+
+void DictionaryMatchEngineTest::testSameWord()
+{
+    const QString word = QStringLiteral("plugh");
+    QString first;
+    QString second;
+    lookup(word, &first);
+    lookup(word, &second);
+    QVERIFY(waitForLookups());
+
+    QCOMPARE(first, FakeDictEngine::definitionOf(word));
+    QCOMPARE(second, FakeDictEngine::definitionOf(word));
+    // the second lookup waits for the answer to the first one
+    QCOMPARE(m_dictEngine->requests.value(word), 1);
+}
+
+void DictionaryMatchEngineTest::testLastWaiterDisconnects()
+{
+    const QString word = QStringLiteral("xyzzy");
+    m_dictEngine->answerRightAway = false;
+
+    QString first;
+    QString second;
+    lookup(word, &first);
+    lookup(word, &second);
+    QTRY_VERIFY(m_dictEngine->isConnected(word, m_matchEngine.get()));
+
+    // both are waiting, past the delay before asking
+    QTest::qWait(500);
+    QVERIFY(m_dictEngine->isConnected(word, m_matchEngine.get()));
+
+    m_dictEngine->answer(word);
+    QVERIFY(waitForLookups());
+    QCOMPARE(first, FakeDictEngine::definitionOf(word));
+    QCOMPARE(second, FakeDictEngine::definitionOf(word));
+
+    QTRY_VERIFY(!m_dictEngine->isConnected(word, m_matchEngine.get()));
+    QCOMPARE(m_dictEngine->requests.value(word), 1);
+}
+
+QTEST_MAIN(DictionaryMatchEngineTest)
+
+#include "dictionarymatchenginetest.moc"
@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include <QTest>
+
+#include "dictionaryparser.h"
+
+class DictionaryParserTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSenses();
+    void testMarkup();
+    void testNoDefinitions_data();
+    void testNoDefinitions();
+};
+
+void DictionaryParserTest::testSenses()
+{
+    const QString response = QStringLiteral(
+        "<dl>\n<dt><b>cat</b></dt>\n<dd>"
+        "\n<br>\n<b>    n 1:</b> feline mammal usually having thick soft fur and no         ability to roar"
+        "\n<br>\n<b>    2:</b> an informal term for a youth or man"
+        "\n<br>\n<b>    v 1:</b> beat with a cat-o'-nine-tails</dd></dl>");
+
+    const DictionaryDefinitions definitions = parseDefinitions(response);
+    QCOMPARE(definitions.lineCount, 3);
+    QCOMPARE(definitions.senses.size(), 3);
+    QCOMPARE(definitions.senses.at(0).partOfSpeech, QStringLiteral("n"));
+    QCOMPARE(definitions.senses.at(0).definition, QStringLiteral("feline mammal usually having thick soft fur and no ability to roar"));
+    // a sense without part of speech has the one of the sense before
+    QCOMPARE(definitions.senses.at(1).partOfSpeech, QStringLiteral("n"));
+    QCOMPARE(definitions.senses.at(1).definition, QStringLiteral("an informal term for a youth or man"));
+    QCOMPARE(definitions.senses.at(2).partOfSpeech, QStringLiteral("v"));
+}
+
+void DictionaryParserTest::testMarkup()
+{
+    const QString response = QStringLiteral(
+        "<dl>\r\n<dt><b>dog</b></dt>\r\n<dd>"
+        "\n<br>\n<b> n 1:</b> a member of the genus Canis [syn: <a href=\"domestic dog\">domestic dog</a>]"
+        "\n<br>\nsee also < and more"
+        "\n<br>\n<b> v 12:</b> go after</dd></dl>");
+
+    const DictionaryDefinitions definitions = parseDefinitions(response);
+    // lines which do not start a sense are counted, but give none
+    QCOMPARE(definitions.lineCount, 3);
+    QCOMPARE(definitions.senses.size(), 2);
+    QCOMPARE(definitions.senses.at(0).definition, QStringLiteral("a member of the genus Canis [syn: domestic dog]"));
+    QCOMPARE(definitions.senses.at(1).partOfSpeech, QStringLiteral("v"));
+    QCOMPARE(definitions.senses.at(1).definition, QStringLiteral("go after"));
+}
+
+void DictionaryParserTest::testNoDefinitions_data()
+{
+    QTest::addColumn<QString>("response");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("word only") << QStringLiteral("<dl>\n<dt><b>cat</b></dt>\n<dd></dd></dl>");
+    QTest::newRow("no senses") << QStringLiteral("cat\nno match here");
+}
+
+void DictionaryParserTest::testNoDefinitions()
+{
+    QFETCH(QString, response);
+    QVERIFY(parseDefinitions(response).senses.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(DictionaryParserTest)
+
+#include "dictionaryparsertest.moc"
@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include "dictddatabase.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+// Offsets and lengths in the index are numbers in base 64, most significant digit first
+bool decodeNumber(const char *data, int length, qint64 &number)
+{
+    number = 0;
+    for (int i = 0; i < length; ++i) {
+        const char c = data[i];
+        int digit;
+        if (c >= 'A' && c <= 'Z') {
+            digit = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            digit = c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            digit = c - '0' + 52;
+        } else if (c == '+') {
+            digit = 62;
+        } else if (c == '/') {
+            digit = 63;
+        } else {
+            return false;
+        }
+        number = number * 64 + digit;
+    }
+    return length > 0;
+}
+
+// Turns the raw definitions into the HTML the dict data engine makes of them
+QString toHtml(const QStringList &definitions)
+{
+    static const QRegularExpression linkRx(QStringLiteral("\\{(.*?)\\}"));
+    static const QRegularExpression senseRx(QStringLiteral("([1-9]{1,2}:)"));
+    static const QRegularExpression sensePrefixRx(QStringLiteral("^([\\s\\S]*[1-9]{1,2}:)"));
+
+    QString html = QStringLiteral("<dl>\n");
+    for (const QString &definition : definitions) {
+        const QStringList lines = definition.split(QLatin1Char('\n'));
+        bool isFirst = true;
+        for (QString line : lines) {
+            line.replace(linkRx, QStringLiteral("<a href=\"\\1\">\\1</a>"));
+            if (isFirst) {
+                html += QLatin1String("<dt><b>") + line + QLatin1String("</b></dt>\n<dd>");
+                isFirst = false;
+                continue;
+            }
+            if (line.contains(senseRx)) {
+                html += QLatin1String("\n<br>\n");
+            }
+            line.replace(sensePrefixRx, QStringLiteral("<b>\\1</b>"));
+            html += line;
+        }
+        html += QLatin1String("</dd>");
+    }
+    html += QLatin1String("</dl>");
+    return html;
+}
+
+// dictfmt writes its 00-database- entries at the top, there is no need to go through the whole index
+bool hasAllCharsEntry(const char *index, qint64 size)
+{
+    constexpr int s_headerLines = 64;
+    qint64 start = 0;
+    for (int line = 0; line < s_headerLines && start < size; ++line) {
+        const void *newline = memchr(index + start, '\n', size - start);
+        const qint64 end = newline ? static_cast<const char *>(newline) - index : size;
+        if (QByteArray::fromRawData(index + start, end - start).startsWith("00-database-allchars\t")) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+QStringList databaseDirs()
+{
+    // where dictd databases are installed by distributions, and where users may put their own
+    QStringList dirs = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("dictd"), QStandardPaths::LocateDirectory);
+    dirs << QStringLiteral("/usr/share/dictd") << QStringLiteral("/usr/local/share/dictd");
+    dirs.removeDuplicates();
+    return dirs;
+}
+}
+
+DictdDatabase::DictdDatabase(const QString &indexPath)
+    : m_indexFile(indexPath)
+{
+    if (!m_indexFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    m_indexSize = m_indexFile.size();
+    m_index = reinterpret_cast<const char *>(m_indexFile.map(0, m_indexSize));
+    if (!m_index) {
+        return;
+    }
+
+    // dictd marks indexes sorted by all characters with an entry of this name
+    m_allChars = hasAllCharsEntry(m_index, m_indexSize);
+
+    const QFileInfo indexInfo(indexPath);
+    QString dataPath = indexInfo.path() + QLatin1Char('/') + indexInfo.completeBaseName() + QLatin1String(".dict");
+    if (!QFile::exists(dataPath)) {
+        dataPath += QLatin1String(".dz");
+    }
+    m_data.reset(new DictdDataFile(dataPath));
+}
+
+std::shared_ptr<const DictdDatabase> DictdDatabase::find(const QString &name)
+{
+    // opened once per process and shared; what is not installed is looked for again, it may be installed by now
+    static QMutex mutex;
+    static QHash<QString, std::shared_ptr<const DictdDatabase>> databases;
+
+    QMutexLocker locker(&mutex);
+    auto it = databases.constFind(name);
+    if (it != databases.constEnd()) {
+        return *it;
+    }
+
+    std::shared_ptr<const DictdDatabase> database;
+    const QStringList dirs = databaseDirs();
+    for (const QString &dir : dirs) {
+        const QString indexPath = dir + QLatin1Char('/') + name + QLatin1String(".index");
+        if (QFileInfo::exists(indexPath)) {
+            auto candidate = std::make_shared<const DictdDatabase>(indexPath);
+            if (candidate->isValid()) {
+                database = candidate;
+                break;
+            }
+        }
+    }
+    if (database) {
+        databases.insert(name, database);
+    }
+    return database;
+}
+
+bool DictdDatabase::isValid() const
+{
+    return m_index && m_data && m_data->isValid();
+}
+
+QByteArray DictdDatabase::sortKey(const char *data, int length) const
+{
+    // Like dictd, compare case insensitively and, unless told otherwise, only
+    // by letters, digits and spaces. Bytes of UTF-8 sequences are kept as they are.
+    QByteArray key;
+    key.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        const uchar c = data[i];
+        if (c >= 0x80) {
+            key.append(char(c));
+        } else if (m_allChars || isalnum(c) || c == ' ') {
+            key.append(char(tolower(c)));
+        }
+    }
+    return key;
+}
+
+QStringList DictdDatabase::definitions(const QString &word) const
+{
+    QStringList result;
+    if (!isValid()) {
+        return result;
+    }
+
+    const QByteArray utf8 = word.toUtf8();
+    const QByteArray key = sortKey(utf8.constData(), utf8.size());
+
+    const auto lineStart = [this](qint64 position) {
+        while (position > 0 && m_index[position - 1] != '\n') {
+            --position;
+        }
+        return position;
+    };
+    const auto lineEnd = [this](qint64 position) {
+        const void *newline = memchr(m_index + position, '\n', m_indexSize - position);
+        return newline ? static_cast<const char *>(newline) - m_index : m_indexSize;
+    };
+    const auto headwordLength = [this](qint64 start, qint64 end) {
+        const void *tab = memchr(m_index + start, '\t', end - start);
+        return tab ? static_cast<const char *>(tab) - (m_index + start) : end - start;
+    };
+
+    // find the first line with a headword not sorting before the word
+    qint64 low = 0;
+    qint64 high = m_indexSize;
+    while (low < high) {
+        const qint64 start = lineStart(low + (high - low) / 2);
+        const qint64 end = lineEnd(start);
+        if (sortKey(m_index + start, headwordLength(start, end)) < key) {
+            low = end + 1;
+        } else {
+            high = start;
+        }
+    }
+
+    // all the lines with that headword follow each other
+    for (qint64 start = low; start < m_indexSize;) {
+        const qint64 end = lineEnd(start);
+        const QByteArray line = QByteArray::fromRawData(m_index + start, end - start);
+        const int length = headwordLength(start, end);
+        if (sortKey(m_index + start, length) != key) {
+            break;
+        }
+
+        // newer indexes may have the original headword in a fourth column
+        const int offsetEnd = line.indexOf('\t', length + 1);
+        int sizeEnd = offsetEnd != -1 ? line.indexOf('\t', offsetEnd + 1) : -1;
+        if (sizeEnd == -1) {
+            sizeEnd = line.size();
+        }
+        qint64 offset;
+        qint64 size;
+        if (offsetEnd != -1 && decodeNumber(line.constData() + length + 1, offsetEnd - length - 1, offset)
+            && decodeNumber(line.constData() + offsetEnd + 1, sizeEnd - offsetEnd - 1, size)) {
+            const QByteArray definition = m_data->read(offset, size);
+            if (!definition.isEmpty()) {
+                result.append(QString::fromUtf8(definition).trimmed());
+            }
+        }
+        start = end + 1;
+    }
+
+    return result;
+}
+
+QVariantMap DictdDatabase::lookup(const QString &word) const
+{
+    const QStringList found = definitions(word);
+    if (found.isEmpty()) {
+        return QVariantMap();
+    }
+    return {{QStringLiteral("text"), toHtml(found)}};
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#ifndef DICTDDATABASE_H
+#define DICTDDATABASE_H
+
+#include <QFile>
+#include <QStringList>
+#include <QVariantMap>
+
+#include <memory>
+
+#include "dictddatafile.h"
+
+/**
+ * A dictionary installed locally in the format of dictd, i.e. an index
+ * (name.index) and the definitions (name.dict or name.dict.dz).
+ *
+ * The index is memory mapped and searched in place with a binary search,
+ * so looking up a word takes no network and reads only a few pages of the
+ * files. Reading does not change the database, so it can be shared by
+ * threads.
+ */
+class DictdDatabase
+{
+public:
+    /**
+     * @param indexPath The path of the index, the definitions are looked for next to it.
+     */
+    explicit DictdDatabase(const QString &indexPath);
+
+    /**
+     * Returns the installed database called @p name, e.g. "wn", or null if
+     * there is none in the directories dictd databases are installed to
+     */
+    static std::shared_ptr<const DictdDatabase> find(const QString &name);
+
+    bool isValid() const;
+
+    /**
+     * Returns the definitions of @p word as they are stored, the word
+     * being compared the way dictd sorts its indexes
+     */
+    QStringList definitions(const QString &word) const;
+
+    /**
+     * Returns the definitions of @p word in the same shape as the dict data
+     * engine does: the definitions as HTML in "text". The map is empty if
+     * the word is not in the database.
+     */
+    QVariantMap lookup(const QString &word) const;
+
+private:
+    QByteArray sortKey(const char *data, int length) const;
+
+    QFile m_indexFile;
+    const char *m_index = nullptr;
+    qint64 m_indexSize = 0;
+    // whether the index is sorted by all characters rather than only alphanumeric ones
+    bool m_allChars = false;
+    std::unique_ptr<DictdDataFile> m_data;
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include "dictddatafile.h"
+
+#include <QDebug>
+
+#include <zlib.h>
+
+#include <limits>
+
+namespace
+{
+// gzip header flags
+constexpr uchar s_flagHeaderCrc = 0x02;
+constexpr uchar s_flagExtra = 0x04;
+constexpr uchar s_flagName = 0x08;
+constexpr uchar s_flagComment = 0x10;
+
+quint16 readLittleEndian16(const uchar *data)
+{
+    return quint16(data[0]) | quint16(data[1]) << 8;
+}
+}
+
+DictdDataFile::DictdDataFile(const QString &path)
+    : m_file(path)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    m_size = m_file.size();
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return;
+    }
+
+    if (path.endsWith(QLatin1String(".dz")) && !readDictzipHeader()) {
+        qWarning() << "Not a dictzip file:" << path;
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+}
+
+bool DictdDataFile::isValid() const
+{
+    return m_data;
+}
+
+bool DictdDataFile::readDictzipHeader()
+{
+    // see RFC 1952 for the header, dictzip adds its chunk table as the "RA" extra field
+    if (m_size < 10 || m_data[0] != 0x1f || m_data[1] != 0x8b || m_data[2] != Z_DEFLATED) {
+        return false;
+    }
+    const uchar flags = m_data[3];
+    if (!(flags & s_flagExtra)) {
+        return false;
+    }
+
+    qint64 position = 10;
+    if (position + 2 > m_size) {
+        return false;
+    }
+    const qint64 extraLength = readLittleEndian16(m_data + position);
+    position += 2;
+    const qint64 extraEnd = position + extraLength;
+    if (extraEnd > m_size) {
+        return false;
+    }
+
+    QVector<quint16> chunkSizes;
+    for (qint64 field = position; field + 4 <= extraEnd;) {
+        const quint16 fieldLength = readLittleEndian16(m_data + field + 2);
+        const uchar *fieldData = m_data + field + 4;
+        if (field + 4 + fieldLength > extraEnd) {
+            return false;
+        }
+        if (m_data[field] == 'R' && m_data[field + 1] == 'A' && fieldLength >= 6) {
+            // version, chunk length, chunk count, then the compressed size of every chunk
+            m_chunkLength = readLittleEndian16(fieldData + 2);
+            const int chunkCount = readLittleEndian16(fieldData + 4);
+            if (readLittleEndian16(fieldData) != 1 || fieldLength < 6 + 2 * chunkCount) {
+                return false;
+            }
+            chunkSizes.reserve(chunkCount);
+            for (int i = 0; i < chunkCount; ++i) {
+                chunkSizes.append(readLittleEndian16(fieldData + 6 + 2 * i));
+            }
+        }
+        field += 4 + fieldLength;
+    }
+    if (m_chunkLength == 0 || chunkSizes.isEmpty()) {
+        return false;
+    }
+    position = extraEnd;
+
+    for (uchar skippedString : {s_flagName, s_flagComment}) {
+        if (flags & skippedString) {
+            while (position < m_size && m_data[position] != '\0') {
+                ++position;
+            }
+            ++position;
+        }
+    }
+    if (flags & s_flagHeaderCrc) {
+        position += 2;
+    }
+
+    m_chunkOffsets.reserve(chunkSizes.size() + 1);
+    m_chunkOffsets.append(position);
+    for (quint16 chunkSize : qAsConst(chunkSizes)) {
+        position += chunkSize;
+        m_chunkOffsets.append(position);
+    }
+    if (position > m_size) {
+        return false;
+    }
+
+    m_compressed = true;
+    return true;
+}
+
+bool DictdDataFile::inflateChunk(int chunk, QByteArray &out) const
+{
+    out.resize(m_chunkLength);
+
+    z_stream stream = {};
+    // the chunks are raw deflate streams, flushed so each can be inflated on its own
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = const_cast<Bytef *>(m_data + m_chunkOffsets.at(chunk));
+    stream.avail_in = m_chunkOffsets.at(chunk + 1) - m_chunkOffsets.at(chunk);
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = m_chunkLength;
+
+    const int result = inflate(&stream, Z_SYNC_FLUSH);
+    out.resize(m_chunkLength - stream.avail_out);
+    inflateEnd(&stream);
+
+    return result == Z_OK || result == Z_STREAM_END;
+}
+
+QByteArray DictdDataFile::read(qint64 offset, qint64 length) const
+{
+    if (!m_data || offset < 0 || length <= 0) {
+        return QByteArray();
+    }
+
+    if (!m_compressed) {
+        if (offset >= m_size) {
+            return QByteArray();
+        }
+        return QByteArray(reinterpret_cast<const char *>(m_data) + offset, qMin(length, m_size - offset));
+    }
+
+    // the last chunk may be shorter, reading stops there
+    const qint64 uncompressedSize = qint64(m_chunkOffsets.size() - 1) * m_chunkLength;
+    if (offset >= uncompressedSize) {
+        return QByteArray();
+    }
+    length = qMin(length, uncompressedSize - offset);
+    if (length > std::numeric_limits<int>::max()) {
+        return QByteArray();
+    }
+
+    QByteArray result;
+    result.reserve(length);
+
+    QByteArray chunkData;
+    const qint64 end = offset + length;
+    const qint64 lastChunk = (end - 1) / m_chunkLength;
+    for (qint64 chunk = offset / m_chunkLength; chunk <= lastChunk; ++chunk) {
+        if (!inflateChunk(int(chunk), chunkData)) {
+            qWarning() << "Could not inflate chunk" << chunk << "of" << m_file.fileName();
+            return QByteArray();
+        }
+        const qint64 chunkStart = chunk * m_chunkLength;
+        const qint64 from = qMax(offset, chunkStart) - chunkStart;
+        const qint64 to = qMin<qint64>(end - chunkStart, chunkData.size());
+        if (from < to) {
+            result.append(chunkData.constData() + from, to - from);
+        }
+    }
+    return result;
+}
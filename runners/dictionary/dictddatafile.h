@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#ifndef DICTDDATAFILE_H
+#define DICTDDATAFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+
+/**
+ * The definitions of a dictd database, either plain (.dict) or compressed
+ * with dictzip (.dict.dz). The file is memory mapped, and of compressed
+ * files only the chunks holding the requested range are inflated.
+ *
+ * Reading does not change the object, so it can be shared by threads.
+ */
+class DictdDataFile
+{
+public:
+    explicit DictdDataFile(const QString &path);
+
+    bool isValid() const;
+
+    /**
+     * Returns @p length bytes from @p offset on in the uncompressed data
+     */
+    QByteArray read(qint64 offset, qint64 length) const;
+
+private:
+    bool readDictzipHeader();
+    bool inflateChunk(int chunk, QByteArray &out) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+
+    bool m_compressed = false;
+    int m_chunkLength = 0;
+    // where every chunk starts in the file, followed by where the last one ends
+    QVector<qint64> m_chunkOffsets;
+};
+
+#endif
@@ -4,12 +4,36 @@
  */
 
 #include "dictionarymatchengine.h"
+#include "dictddatabase.h"
 #include <KRunner/AbstractRunner>
 #include <QDeadlineTimer>
 #include <QDebug>
 #include <QMetaMethod>
 #include <QThread>
 
+namespace
+{
+// Time the query has to stay the same before the dictionary server is asked
+constexpr int s_debounceMSecs = 300;
+// How often a waiting lookup checks whether its query is still current
+constexpr int s_pollMSecs = 50;
+constexpr int s_timeoutMSecs = 30 * 1000;
+constexpr int s_cachedDefinitions = 50;
+
+// Waits for @p msecs, returns false if @p context has become invalid meanwhile
+bool sleepWhileValid(const Plasma::RunnerContext &context, int msecs)
+{
+    QDeadlineTimer deadline(msecs);
+    while (!deadline.hasExpired()) {
+        if (!context.isValid()) {
+            return false;
+        }
+        QThread::msleep(qMin<qint64>(s_pollMSecs, deadline.remainingTime()));
+    }
+    return context.isValid();
+}
+}
+
 DictionaryMatchEngine::DictionaryMatchEngine(Plasma::DataEngine *dictionaryEngine, QObject *parent)
     : QObject(parent)
     , m_dictionaryEngine(dictionaryEngine)
@@ -19,11 +43,23 @@ DictionaryMatchEngine::DictionaryMatchEngine(Plasma::DataEngine *dictionaryEngin
      * and this extra connection handles the second case. */
     Q_ASSERT(m_dictionaryEngine);
     connect(m_dictionaryEngine, &Plasma::DataEngine::sourceAdded, this, &DictionaryMatchEngine::sourceAdded);
+
+    m_definitionCache.setMaxCost(s_cachedDefinitions);
+
+    m_localDatabase = DictdDatabase::find(QStringLiteral("wn"));
 }
 
 /* This function should be called from a different thread. */
-QString DictionaryMatchEngine::lookupWord(const QString &word)
+QString DictionaryMatchEngine::lookupWord(const QString &word, const Plasma::RunnerContext &context)
 {
+    // Words the local dictionary knows need neither the network nor the data engine
+    if (m_localDatabase) {
+        const QString definition = m_localDatabase->lookup(word).value(QStringLiteral("text")).toString();
+        if (!definition.isEmpty()) {
+            return definition;
+        }
+    }
+
     if (!m_dictionaryEngine) {
         qDebug() << "Could not find dictionary data engine.";
         return QString();
@@ -33,30 +69,58 @@ QString DictionaryMatchEngine::lookupWord(const QString &word)
         return QString();
     }
 
-    ThreadData data;
+    {
+        QMutexLocker cacheLocker(&m_cacheMutex);
+        if (const QString *definition = m_definitionCache.object(word)) {
+            return *definition;
+        }
+    }
+
+    // Don't ask for every keystroke, only for what the user has settled on
+    if (!sleepWhileValid(context, s_debounceMSecs)) {
+        return QString();
+    }
 
-    m_wordLock.lockForWrite();
-    m_lockers.insert(word, &data);
-    m_wordLock.unlock();
+    std::shared_ptr<Request> request;
+    {
+        QMutexLocker requestsLocker(&m_requestsMutex);
+        request = m_requests.value(word);
+        if (!request) {
+            // The first thread to look the word up asks for it, the others wait for the same answer
+            request = std::make_shared<Request>();
+            m_requests.insert(word, request);
+            QMetaObject::invokeMethod(this, "sourceAdded", Qt::QueuedConnection, Q_ARG(const QString &, word));
+        }
+        ++request->waiters;
+    }
 
-    QMetaObject::invokeMethod(this, "sourceAdded", Qt::QueuedConnection, Q_ARG(const QString &, word));
-    QMutexLocker locker(&data.mutex);
-    if (!data.waitCondition.wait(&data.mutex, QDeadlineTimer(30 * 1000))) { // Timeout after 30 seconds
+    QMutexLocker locker(&request->mutex);
+    // Wake up now and then to give up once the query has changed, instead of keeping the thread
+    const QDeadlineTimer deadline(s_timeoutMSecs);
+    while (!request->done && context.isValid() && !deadline.hasExpired()) {
+        request->waitCondition.wait(&request->mutex, QDeadlineTimer(qMin<qint64>(s_pollMSecs, deadline.remainingTime())));
+    }
+    if (!request->done && deadline.hasExpired()) {
         qDebug() << "The dictionary data engine timed out (word:" << word << ")";
     }
+    const bool done = request->done;
+    const QString definition = request->definition;
     locker.unlock();
 
-    QMetaObject::invokeMethod(this, "sourceRemoved", Qt::QueuedConnection, Q_ARG(const QString &, word));
-    // after a timeout, if dataUpdated gets m_wordLock here, it can lock data->mutex successfully.
-
-    m_wordLock.lockForWrite();
-    m_lockers.remove(word, &data);
-    m_wordLock.unlock();
-
-    // after a timeout, if dataUpdated gets m_wordLock here, it won't see this data instance anymore.
+    {
+        QMutexLocker requestsLocker(&m_requestsMutex);
+        // The last one waiting for the word cleans up
+        if (--request->waiters == 0 && m_requests.value(word) == request) {
+            m_requests.remove(word);
+            QMetaObject::invokeMethod(this, "sourceRemoved", Qt::QueuedConnection, Q_ARG(const QString &, word));
+        }
+    }
 
-    locker.relock();
-    return data.definition;
+    if (done && !definition.isEmpty()) {
+        QMutexLocker cacheLocker(&m_cacheMutex);
+        m_definitionCache.insert(word, new QString(definition));
+    }
+    return definition;
 }
 
 void DictionaryMatchEngine::sourceAdded(const QString &source)
@@ -77,13 +141,18 @@ void DictionaryMatchEngine::dataUpdated(const QString &source, const Plasma::Dat
 
     QString definition(result[QLatin1String("text")].toString());
 
-    m_wordLock.lockForRead();
-    for (ThreadData *data : qAsConst(m_lockers)) {
-        QMutexLocker locker(&data->mutex);
-        /* Because of QString's CoW semantics, we don't have to worry about
-         * the overhead of assigning this to every item. */
-        data->definition = definition;
-        data->waitCondition.wakeOne();
+    std::shared_ptr<Request> request;
+    {
+        QMutexLocker requestsLocker(&m_requestsMutex);
+        request = m_requests.value(source);
     }
-    m_wordLock.unlock();
+    // Nobody is waiting for that word (anymore)
+    if (!request) {
+        return;
+    }
+
+    QMutexLocker locker(&request->mutex);
+    request->definition = definition;
+    request->done = true;
+    request->waitCondition.wakeAll();
 }
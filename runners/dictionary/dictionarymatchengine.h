@@ -7,14 +7,18 @@
 #define DICTIONARYMATCHENGINE_H
 
 #include <Plasma/DataEngine>
+#include <QCache>
 #include <QHash>
-#include <QMultiMap>
 #include <QMutex>
-#include <QReadWriteLock>
 #include <QWaitCondition>
 
+#include <memory>
+
+class DictdDatabase;
+
 namespace Plasma
 {
+class RunnerContext;
 }
 class DictionaryMatchEngine : public QObject
 {
@@ -22,17 +26,31 @@ class DictionaryMatchEngine : public QObject
 
 public:
     explicit DictionaryMatchEngine(Plasma::DataEngine *dictionaryEngine, QObject *parent = nullptr);
-    QString lookupWord(const QString &word);
+    /**
+     * Returns the definition of @p word, or an empty string. The lookup is
+     * given up as soon as @p context is no longer valid, and only made once
+     * the query has not changed for a moment.
+     */
+    QString lookupWord(const QString &word, const Plasma::RunnerContext &context);
 
 private:
-    struct ThreadData {
+    /** The lookup of a word, shared by all threads waiting for that word */
+    struct Request {
         QWaitCondition waitCondition;
         QMutex mutex;
         QString definition;
+        bool done = false;
+        /** Guarded by m_requestsMutex */
+        int waiters = 0;
     };
-    QMultiMap<QString, ThreadData *> m_lockers;
-    QReadWriteLock m_wordLock;
+    QHash<QString, std::shared_ptr<Request>> m_requests;
+    QMutex m_requestsMutex;
+    /** Recently defined words, most recently used ones are kept */
+    QCache<QString, QString> m_definitionCache;
+    QMutex m_cacheMutex;
     Plasma::DataEngine *m_dictionaryEngine;
+    /** The default dictionary of the dict engine, if it is installed locally */
+    std::shared_ptr<const DictdDatabase> m_localDatabase;
 
 private Q_SLOTS:
     void dataUpdated(const QString &name, const Plasma::DataEngine::Data &data);
@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#include "dictionaryparser.h"
+
+namespace
+{
+bool isLowerLetter(QChar c)
+{
+    return c >= QLatin1Char('a') && c <= QLatin1Char('z');
+}
+
+bool isDigit(QChar c)
+{
+    return c >= QLatin1Char('0') && c <= QLatin1Char('9');
+}
+
+// Returns the position after " 12: " at @p position, or -1
+int matchSenseNumber(const QString &line, int position)
+{
+    if (position >= line.size() || line.at(position) != QLatin1Char(' ')) {
+        return -1;
+    }
+    int digits = 0;
+    while (digits < 2 && position + 1 + digits < line.size() && isDigit(line.at(position + 1 + digits))) {
+        ++digits;
+    }
+    const int colon = position + 1 + digits;
+    if (digits == 0 || colon + 1 >= line.size() || line.at(colon) != QLatin1Char(':') || line.at(colon + 1) != QLatin1Char(' ')) {
+        return -1;
+    }
+    return colon + 2;
+}
+
+// Finds the first " pos 1: definition" or " 1: definition" in @p line
+bool parseSense(const QString &line, QString &partOfSpeech, QString &definition)
+{
+    for (int position = 0; position < line.size(); ++position) {
+        if (line.at(position) != QLatin1Char(' ')) {
+            continue;
+        }
+
+        // a part of speech of up to five letters before the number
+        int letters = 0;
+        while (letters < 5 && position + 1 + letters < line.size() && isLowerLetter(line.at(position + 1 + letters))) {
+            ++letters;
+        }
+        if (letters > 0) {
+            const int definitionStart = matchSenseNumber(line, position + 1 + letters);
+            if (definitionStart != -1) {
+                partOfSpeech = line.mid(position + 1, letters);
+                definition = line.mid(definitionStart);
+                return true;
+            }
+        }
+
+        const int definitionStart = matchSenseNumber(line, position);
+        if (definitionStart != -1) {
+            partOfSpeech.clear();
+            definition = line.mid(definitionStart);
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+DictionaryDefinitions parseDefinitions(const QString &response)
+{
+    DictionaryDefinitions result;
+    QString lastPartOfSpeech;
+    bool isFirstLine = true;
+
+    const auto addLine = [&](const QString &line) {
+        if (line.isEmpty()) {
+            return;
+        }
+        // the first line is the word itself
+        if (isFirstLine) {
+            isFirstLine = false;
+            return;
+        }
+        ++result.lineCount;
+
+        QString partOfSpeech;
+        QString definition;
+        if (parseSense(line, partOfSpeech, definition)) {
+            if (!partOfSpeech.isEmpty()) {
+                lastPartOfSpeech = partOfSpeech;
+            }
+            result.senses.append({lastPartOfSpeech, definition});
+        }
+    };
+
+    QString line;
+    // where the tag being skipped ends, looked up once per tag so unclosed ones don't make this quadratic
+    int tagEnd = -1;
+    for (int i = 0; i < response.size(); ++i) {
+        const QChar c = response.at(i);
+        if (c == QLatin1Char('<')) {
+            if (tagEnd < i) {
+                tagEnd = response.indexOf(QLatin1Char('>'), i);
+                if (tagEnd == -1) {
+                    tagEnd = response.size();
+                }
+            }
+            if (tagEnd < response.size()) {
+                i = tagEnd;
+                continue;
+            }
+        }
+
+        if (c == QLatin1Char('\r')) {
+            continue;
+        } else if (c == QLatin1Char('\n')) {
+            addLine(line);
+            line.clear();
+        } else if (c != QLatin1Char(' ') || !line.endsWith(QLatin1Char(' '))) {
+            line.append(c);
+        }
+    }
+    addLine(line);
+
+    // like a single line, a word without definitions has none
+    if (result.lineCount == 0) {
+        result.senses.clear();
+    }
+    return result;
+}
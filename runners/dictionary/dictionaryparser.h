@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ */
+
+#ifndef DICTIONARYPARSER_H
+#define DICTIONARYPARSER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * One meaning of a word, e.g. "n" and "feline mammal usually having thick
+ * soft fur" for "n 1: feline mammal usually having thick soft fur".
+ */
+struct DictionarySense {
+    /** As given for this sense, or else for the ones before it */
+    QString partOfSpeech;
+    QString definition;
+};
+
+struct DictionaryDefinitions {
+    QVector<DictionarySense> senses;
+    /** Lines of definitions, whether they start a sense or not */
+    int lineCount = 0;
+};
+
+/**
+ * Parses the HTML the dict data engine returns for a word: tags and carriage
+ * returns are dropped, runs of spaces collapsed, the line with the word
+ * skipped and every other line starting a sense turned into one.
+ *
+ * The text is gone through once, without regular expressions, so parsing
+ * takes linear time and needs no shared state.
+ */
+DictionaryDefinitions parseDefinitions(const QString &response);
+
+#endif
@@ -4,6 +4,7 @@
  */
 
 #include "dictionaryrunner.h"
+#include "dictionaryparser.h"
 
 #include <KLocalizedString>
 #include <QStringList>
@@ -48,37 +49,23 @@ void DictionaryRunner::match(Plasma::RunnerContext &context)
     if (query.isEmpty()) {
         return;
     }
-    QString returnedQuery = m_engine->lookupWord(query);
-
-    static const QRegExp removeHtml(QLatin1String("<[^>]*>"));
-    QString definitions(returnedQuery);
-    definitions.remove(QLatin1Char('\r')).remove(removeHtml);
-    while (definitions.contains(QLatin1String("  "))) {
-        definitions.replace(QLatin1String("  "), QLatin1String(" "));
-    }
-    QStringList lines = definitions.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
-    if (lines.length() < 2) {
+    QString returnedQuery = m_engine->lookupWord(query, context);
+    if (!context.isValid()) {
         return;
     }
-    lines.removeFirst();
+
+    const DictionaryDefinitions definitions = parseDefinitions(returnedQuery);
 
     QList<Plasma::QueryMatch> matches;
+    matches.reserve(definitions.senses.size());
     int item = 0;
-    static const QRegExp partOfSpeech(QLatin1String("(?: ([a-z]{1,5})){0,1} [0-9]{1,2}: (.*)"));
-    QString lastPartOfSpeech;
-    for (const QString &line : qAsConst(lines)) {
-        if (partOfSpeech.indexIn(line) == -1) {
-            continue;
-        }
-        if (!partOfSpeech.cap(1).isEmpty()) {
-            lastPartOfSpeech = partOfSpeech.cap(1);
-        }
+    for (const DictionarySense &sense : definitions.senses) {
         Plasma::QueryMatch match(this);
-        match.setText(query + QLatin1String(": ") + lastPartOfSpeech);
-        match.setRelevance(1 - (static_cast<double>(++item) / static_cast<double>(lines.length())));
+        match.setText(query + QLatin1String(": ") + sense.partOfSpeech);
+        match.setRelevance(1 - (static_cast<double>(++item) / static_cast<double>(definitions.lineCount)));
         match.setType(Plasma::QueryMatch::InformationalMatch);
         match.setIconName(QStringLiteral("accessories-dictionary"));
-        match.setSubtext(partOfSpeech.cap(2));
+        match.setSubtext(sense.definition);
         matches.append(match);
     }
     context.addMatches(matches);
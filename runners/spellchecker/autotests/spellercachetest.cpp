@@ -0,0 +1,168 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+
+#include "spellercache.h"
+
+/**
+ * Hands out spellers made up front, slowly, and keeps count
+ */
+class SlowLoader
+{
+public:
+    QSharedPointer<Sonnet::Speller> load(const QString &language)
+    {
+        {
+            QMutexLocker lock(&mutex);
+            ++loads[language];
+            ++loading;
+            mostLoading = qMax(mostLoading, loading);
+        }
+        QThread::msleep(300);
+
+        QMutexLocker lock(&mutex);
+        --loading;
+        return spellers.value(language);
+    }
+
+    int loadsOf(const QString &language)
+    {
+        QMutexLocker lock(&mutex);
+        return loads.value(language);
+    }
+
+    QHash<QString, QSharedPointer<Sonnet::Speller>> spellers;
+    QMutex mutex;
+    QHash<QString, int> loads;
+    int loading = 0;
+    int mostLoading = 0;
+};
+
+class SpellerCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testSingleLoader();
+    void testLanguagesLoadAtOnce();
+    void testEvictIdle();
+
+private:
+    /** Asks @p cache for @p language in a thread of its own, like the runner does */
+    void lookup(SpellerCache &cache, const QString &language, QSharedPointer<Sonnet::Speller> *speller);
+    void waitForLookups();
+
+    std::unique_ptr<SlowLoader> m_loader;
+    std::unique_ptr<SpellerCache> m_cache;
+    QList<QThread *> m_threads;
+};
+
+void SpellerCacheTest::init()
+{
+    // the spellers are made here, Sonnet has to be set up in the main thread
+    m_loader.reset(new SlowLoader);
+    for (const QString &language : {QStringLiteral("de"), QStringLiteral("fr")}) {
+        m_loader->spellers.insert(language, QSharedPointer<Sonnet::Speller>(new Sonnet::Speller(language)));
+    }
+    SlowLoader *loader = m_loader.get();
+    m_cache.reset(new SpellerCache([loader](const QString &language) {
+        return loader->load(language);
+    }));
+}
+
+void SpellerCacheTest::cleanup()
+{
+    waitForLookups();
+    qDeleteAll(m_threads);
+    m_threads.clear();
+    m_cache.reset();
+    m_loader.reset();
+}
+
+void SpellerCacheTest::lookup(SpellerCache &cache, const QString &language, QSharedPointer<Sonnet::Speller> *speller)
+{
+    QThread *thread = QThread::create([&cache, language, speller]() {
+        *speller = cache.speller(language);
+    });
+    m_threads.append(thread);
+    thread->start();
+}
+
+void SpellerCacheTest::waitForLookups()
+{
+    for (QThread *thread : qAsConst(m_threads)) {
+        QVERIFY(thread->wait(10000));
+    }
+}
+
+/**
+ * Test if a language asked for by several threads at once is loaded only once
+ */
+void SpellerCacheTest::testSingleLoader()
+{
+    const QString language = QStringLiteral("de");
+    QVector<QSharedPointer<Sonnet::Speller>> spellers(4);
+    for (auto &speller : spellers) {
+        lookup(*m_cache, language, &speller);
+    }
+    waitForLookups();
+
+    QCOMPARE(m_loader->loadsOf(language), 1);
+    for (const auto &speller : qAsConst(spellers)) {
+        QCOMPARE(speller, m_loader->spellers.value(language));
+    }
+
+    // from the cache from now on
+    QCOMPARE(m_cache->speller(language), m_loader->spellers.value(language));
+    QCOMPARE(m_loader->loadsOf(language), 1);
+}
+
+/**
+ * Test if loading a language does not hold up loading another one
+ */
+void SpellerCacheTest::testLanguagesLoadAtOnce()
+{
+    QSharedPointer<Sonnet::Speller> german;
+    QSharedPointer<Sonnet::Speller> french;
+    lookup(*m_cache, QStringLiteral("de"), &german);
+    lookup(*m_cache, QStringLiteral("fr"), &french);
+    waitForLookups();
+
+    QCOMPARE(german, m_loader->spellers.value(QStringLiteral("de")));
+    QCOMPARE(french, m_loader->spellers.value(QStringLiteral("fr")));
+    QCOMPARE(m_loader->mostLoading, 2);
+}
+
+void SpellerCacheTest::testEvictIdle()
+{
+    QVERIFY(!m_cache->evictIdle(0));
+
+    m_cache->speller(QStringLiteral("de"));
+    QTest::qWait(100);
+    m_cache->speller(QStringLiteral("fr"));
+
+    // only the speller not used for long enough goes
+    QVERIFY(m_cache->evictIdle(50));
+    m_cache->speller(QStringLiteral("fr"));
+    QCOMPARE(m_loader->loadsOf(QStringLiteral("fr")), 1);
+    m_cache->speller(QStringLiteral("de"));
+    QCOMPARE(m_loader->loadsOf(QStringLiteral("de")), 2);
+
+    QTest::qWait(100);
+    QVERIFY(!m_cache->evictIdle(50));
+}
+
+QTEST_GUILESS_MAIN(SpellerCacheTest)
+
+#include "spellercachetest.moc"
@@ -16,11 +16,18 @@
 
 #include <KLocalizedString>
 
+// Spellers not used for that long are dropped, to save memory
+static const int s_idleMSecs = 10 * 60 * 1000;
+
 SpellCheckRunner::SpellCheckRunner(QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
     : Plasma::AbstractRunner(parent, metaData, args)
 {
     setObjectName(QStringLiteral("Spell Checker"));
     setSpeed(AbstractRunner::SlowSpeed);
+
+    m_evictTimer.setSingleShot(true);
+    m_evictTimer.setInterval(s_idleMSecs);
+    connect(&m_evictTimer, &QTimer::timeout, this, &SpellCheckRunner::evictIdleSpellers);
 }
 
 SpellCheckRunner::~SpellCheckRunner() = default;
@@ -37,16 +44,35 @@ void SpellCheckRunner::init()
 // Load a default dictionary and some locale names
 void SpellCheckRunner::loadData()
 {
-    // Load the default speller, with the default language
-    auto defaultSpellerIt = m_spellers.find(QString());
-    if (defaultSpellerIt == m_spellers.end()) {
-        defaultSpellerIt = m_spellers.insert(QString(), QSharedPointer<Sonnet::Speller>(new Sonnet::Speller(QString())));
+    // The default speller is kept for as long as the runner, and so are the language names
+    {
+        QMutexLocker lock(&m_spellLock);
+        if (m_defaultSpeller || m_loadingDefaultSpeller) {
+            return;
+        }
+        m_loadingDefaultSpeller = true;
     }
-    auto &defaultSpeller = defaultSpellerIt.value();
+
+    // The first speller creates the loader of Sonnet, which lives in the thread it is created in,
+    // so that has to be the main thread. There is no dictionary for this language, so nothing
+    // else is loaded here.
+    const Sonnet::Speller loaderSpeller(QStringLiteral("-"));
+    Q_UNUSED(loaderSpeller)
+
+    m_loadPool.start([this]() {
+        loadDefaultSpeller();
+    });
+}
+
+void SpellCheckRunner::loadDefaultSpeller()
+{
+    // Load the default speller, with the default language
+    const QSharedPointer<Sonnet::Speller> defaultSpeller(new Sonnet::Speller(QString()));
 
     // store all language names, makes it possible to type "spell german TERM" if english locale is set
     // Need to construct a map between natual language names and names the spell-check recognises.
     const QStringList avail = defaultSpeller->availableLanguages();
+    QMap<QString, QString> languages;
     // We need to filter the available languages so that we associate the natural language
     // name (eg. 'german') with one sub-code.
     QSet<QString> families;
@@ -80,15 +106,37 @@ void SpellCheckRunner::loadData()
         // FIXME: We need someway to map languageCodeToName
         const QString name; // = locale->languageCodeToName(fcode);
         if (!name.isEmpty()) {
-            m_languages[name.toLower()] = code;
+            languages[name.toLower()] = code;
         }
     }
+
+    QMutexLocker lock(&m_spellLock);
+    m_defaultSpeller = defaultSpeller;
+    m_languages = languages;
+    m_loadingDefaultSpeller = false;
+    m_defaultSpellerLoaded.wakeAll();
 }
 
 void SpellCheckRunner::destroydata()
 {
-    // Clear the data arrays to save memory
-    m_spellers.clear();
+    // Keep the spellers for the next session, unless they are not used for a while
+    m_evictTimer.start();
+}
+
+QSharedPointer<Sonnet::Speller> SpellCheckRunner::defaultSpeller()
+{
+    QMutexLocker lock(&m_spellLock);
+    while (m_loadingDefaultSpeller) {
+        m_defaultSpellerLoaded.wait(&m_spellLock);
+    }
+    return m_defaultSpeller;
+}
+
+void SpellCheckRunner::evictIdleSpellers()
+{
+    if (m_spellers.evictIdle(s_idleMSecs)) {
+        m_evictTimer.start();
+    }
 }
 
 void SpellCheckRunner::reloadConfiguration()
@@ -119,11 +167,10 @@ void SpellCheckRunner::reloadConfiguration()
 
 /* Take the input query, split into a list, and see if it contains a language to spell in.
  * Return the empty string if we can't match a language. */
-QString SpellCheckRunner::findLang(const QStringList &terms)
+QString SpellCheckRunner::findLang(const QStringList &terms, const Sonnet::Speller &defaultSpeller)
 {
-    const auto &defaultSpeller = m_spellers[QString()];
     // If first term is a language code (like en_GB), set it as the spell-check language
-    if (!terms.isEmpty() && defaultSpeller->availableLanguages().contains(terms[0])) {
+    if (!terms.isEmpty() && defaultSpeller.availableLanguages().contains(terms[0])) {
         return terms[0];
     }
     // If we have two terms and the first is a language name (eg 'french'),
@@ -131,14 +178,19 @@ QString SpellCheckRunner::findLang(const QStringList &terms)
     else if (terms.count() >= 2) {
         QString code;
         {
+            QMap<QString, QString> languages;
+            {
+                QMutexLocker lock(&m_spellLock);
+                languages = m_languages;
+            }
             // Is this a descriptive language name?
-            QMap<QString, QString>::const_iterator it = m_languages.constFind(terms[0].toLower());
-            if (it != m_languages.constEnd()) {
+            QMap<QString, QString>::const_iterator it = languages.constFind(terms[0].toLower());
+            if (it != languages.constEnd()) {
                 code = *it;
             }
             // Maybe it is a subset of a language code?
             else {
-                QStringList codes = QStringList(m_languages.values()).filter(terms[0]);
+                QStringList codes = QStringList(languages.values()).filter(terms[0]);
                 if (!codes.isEmpty()) {
                     code = codes.first();
                 }
@@ -147,7 +199,7 @@ QString SpellCheckRunner::findLang(const QStringList &terms)
 
         if (!code.isEmpty()) {
             // We found a valid language! Check still available
-            const QStringList avail = defaultSpeller->availableLanguages();
+            const QStringList avail = defaultSpeller.availableLanguages();
             // Does the spell-checker like it?
             if (avail.contains(code)) {
                 return code;
@@ -176,24 +228,19 @@ void SpellCheckRunner::match(Plasma::RunnerContext &context)
     }
 
     // Pointer to speller object with our chosen language
-    QSharedPointer<Sonnet::Speller> speller = m_spellers[QString()];
+    QSharedPointer<Sonnet::Speller> speller = defaultSpeller();
+    if (!speller) {
+        return;
+    }
 
     if (speller->isValid()) {
         QStringList terms = query.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-        const QString lang = findLang(terms);
+        const QString lang = findLang(terms, *speller);
         // If we found a language, create a new speller object using it.
         if (!lang.isEmpty()) {
             // First term is the language
             terms.removeFirst();
-            // New speller object if we don't already have one
-            if (!m_spellers.contains(lang)) {
-                QMutexLocker lock(&m_spellLock);
-                // Check nothing happened while we were acquiring the lock
-                if (!m_spellers.contains(lang)) {
-                    m_spellers[lang] = QSharedPointer<Sonnet::Speller>(new Sonnet::Speller(lang));
-                }
-            }
-            speller = m_spellers[lang];
+            speller = m_spellers.speller(lang);
             // Rejoin the strings
             query = terms.join(QLatin1Char(' '));
         }
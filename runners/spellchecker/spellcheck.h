@@ -10,8 +10,14 @@
 #include <sonnet/speller.h>
 
 #include <KRunner/AbstractRunner>
+#include <QMap>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWaitCondition>
+
+#include "spellercache.h"
 
 /**
  * This checks the spelling of query
@@ -35,15 +41,34 @@ protected Q_SLOTS:
 
     void loadData();
     void destroydata();
+    void evictIdleSpellers();
 
 private:
-    QString findLang(const QStringList &terms);
+    QString findLang(const QStringList &terms, const Sonnet::Speller &defaultSpeller);
+    /**
+     * Loads the speller for the default language and the language names, in
+     * a thread of the pool
+     */
+    void loadDefaultSpeller();
+    /**
+     * Returns the speller for the default language, waiting for it if it is
+     * being loaded, or null if loading it has not been started
+     */
+    QSharedPointer<Sonnet::Speller> defaultSpeller();
 
     QString m_triggerWord;
-    QMap<QString, QString> m_languages; // key=language name, value=language code
     bool m_requireTriggerWord;
-    QMap<QString, QSharedPointer<Sonnet::Speller>> m_spellers; // spellers
-    QMutex m_spellLock; // Lock held when constructing a new speller
+
+    QMutex m_spellLock; // Guards the members below
+    QWaitCondition m_defaultSpellerLoaded;
+    QSharedPointer<Sonnet::Speller> m_defaultSpeller; // Kept for as long as the runner
+    bool m_loadingDefaultSpeller = false;
+    QMap<QString, QString> m_languages; // key=language name, value=language code
+
+    SpellerCache m_spellers;
+    QTimer m_evictTimer;
+    // Last, so it is destroyed first and waits for the loading, which uses the members above
+    QThreadPool m_loadPool;
 };
 
 #endif
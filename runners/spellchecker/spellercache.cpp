@@ -0,0 +1,59 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#include "spellercache.h"
+
+#include <QMutexLocker>
+
+SpellerCache::SpellerCache(const Loader &loader)
+    : m_loader(loader)
+{
+}
+
+QSharedPointer<Sonnet::Speller> SpellerCache::defaultLoader(const QString &language)
+{
+    return QSharedPointer<Sonnet::Speller>(new Sonnet::Speller(language));
+}
+
+QSharedPointer<Sonnet::Speller> SpellerCache::speller(const QString &language)
+{
+    QMutexLocker lock(&m_mutex);
+    while (m_loading.contains(language)) {
+        m_loaded.wait(&m_mutex);
+    }
+
+    auto it = m_spellers.find(language);
+    if (it != m_spellers.end()) {
+        it->lastUsed.start();
+        return it->speller;
+    }
+
+    // Load without holding the lock, so other languages can be used meanwhile
+    m_loading.insert(language);
+    lock.unlock();
+    const QSharedPointer<Sonnet::Speller> speller = m_loader(language);
+    lock.relock();
+
+    CachedSpeller &cached = m_spellers[language];
+    cached.speller = speller;
+    cached.lastUsed.start();
+    m_loading.remove(language);
+    m_loaded.wakeAll();
+    return speller;
+}
+
+bool SpellerCache::evictIdle(qint64 idleMSecs)
+{
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_spellers.begin(); it != m_spellers.end();) {
+        if (it->lastUsed.hasExpired(idleMSecs)) {
+            it = m_spellers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return !m_spellers.isEmpty();
+}
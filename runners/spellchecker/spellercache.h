@@ -0,0 +1,62 @@
+/*
+ *   SPDX-FileCopyrightText: 2021 Plasma Development Team <plasma-devel@kde.org>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#ifndef SPELLERCACHE_H
+#define SPELLERCACHE_H
+
+#include <sonnet/speller.h>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+#include <functional>
+
+/**
+ * The spellers of the languages asked for, kept until they have not been
+ * used for a while. Loading a dictionary takes a moment, so only one thread
+ * loads a language, and the others asking for it meanwhile wait for it.
+ * Other languages can be used while one is loaded.
+ */
+class SpellerCache
+{
+public:
+    using Loader = std::function<QSharedPointer<Sonnet::Speller>(const QString &language)>;
+
+    /**
+     * @param loader creates the speller of a language, in the thread asking for it
+     */
+    explicit SpellerCache(const Loader &loader = defaultLoader);
+
+    /**
+     * Returns the speller for @p language, loading it unless it is cached
+     */
+    QSharedPointer<Sonnet::Speller> speller(const QString &language);
+
+    /**
+     * Drops the spellers not used for @p idleMSecs, returns whether any are left
+     */
+    bool evictIdle(qint64 idleMSecs);
+
+private:
+    static QSharedPointer<Sonnet::Speller> defaultLoader(const QString &language);
+
+    struct CachedSpeller {
+        QSharedPointer<Sonnet::Speller> speller;
+        QElapsedTimer lastUsed;
+    };
+
+    const Loader m_loader;
+    QMutex m_mutex; // Guards the members below
+    QWaitCondition m_loaded;
+    QHash<QString, CachedSpeller> m_spellers; // key=language code
+    QSet<QString> m_loading;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ *   SPDX-FileCopyrightText: %{CURRENT_YEAR} %{AUTHOR} <%{EMAIL}>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#include "%{APPNAMELC}.h"
+
+// KF
+#include <KPluginFactory>
+
+%{APPNAME}::%{APPNAME}(QObject *parent, const QVariantList &args)
+    : ComicProvider(parent, args)
+{
+    // TODO: replace with the url of the page of the requested strip
+    mWebsiteUrl = QUrl(QStringLiteral("https://kde.org/?date=") + requestedDate().toString(Qt::ISODate));
+
+    requestPage(mWebsiteUrl, Page);
+}
+
+%{APPNAME}::~%{APPNAME}()
+{
+}
+
+ComicProvider::IdentifierType %{APPNAME}::identifierType() const
+{
+    return DateIdentifier;
+}
+
+QUrl %{APPNAME}::websiteUrl() const
+{
+    return mWebsiteUrl;
+}
+
+QImage %{APPNAME}::image() const
+{
+    return mImage;
+}
+
+QString %{APPNAME}::identifier() const
+{
+    return pluginName() + QLatin1Char(':') + requestedDate().toString(Qt::ISODate);
+}
+
+void %{APPNAME}::pageRetrieved(int id, const QByteArray &data)
+{
+    if (id == Page) {
+        // TODO: read the url of the strip from the page in data
+        const QUrl imageUrl(QStringLiteral("https://kde.org/stuff/clipart/logo/kde-logo-white-blue-rounded-128x128.png"));
+        requestPage(imageUrl, Image);
+        return;
+    }
+
+    if (id == Image) {
+        mImage = QImage::fromData(data);
+        if (mImage.isNull()) {
+            Q_EMIT error(this);
+            return;
+        }
+        Q_EMIT finished(this);
+    }
+}
+
+void %{APPNAME}::pageError(int id, const QString &message)
+{
+    Q_UNUSED(id)
+    Q_UNUSED(message)
+
+    Q_EMIT error(this);
+}
+
+K_PLUGIN_CLASS_WITH_JSON(%{APPNAME}, "%{APPNAMELC}.json")
+
+#include "%{APPNAMELC}.moc"
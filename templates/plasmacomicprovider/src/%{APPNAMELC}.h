@@ -0,0 +1,47 @@
+/*
+ *   SPDX-FileCopyrightText: %{CURRENT_YEAR} %{AUTHOR} <%{EMAIL}>
+ *
+ *   SPDX-License-Identifier: LGPL-2.0-only
+ */
+
+#ifndef %{APPNAMEUC}_H
+#define %{APPNAMEUC}_H
+
+#include <plasma/comicprovider/comicprovider.h>
+// Qt
+#include <QImage>
+#include <QUrl>
+
+class %{APPNAME} : public ComicProvider
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Creates a new %{APPNAME}.
+     *
+     * @param parent the parent object
+     * @param args the requested strip and the metadata of the comic package
+     */
+    %{APPNAME}(QObject *parent, const QVariantList &args);
+
+    /**
+     * Destroys the provider.
+     */
+    ~%{APPNAME}() override;
+
+    IdentifierType identifierType() const override;
+    QUrl websiteUrl() const override;
+    QImage image() const override;
+    QString identifier() const override;
+
+protected:
+    void pageRetrieved(int id, const QByteArray &data) override;
+    void pageError(int id, const QString &message) override;
+
+private:
+    QUrl mWebsiteUrl;
+    QImage mImage;
+};
+
+#endif
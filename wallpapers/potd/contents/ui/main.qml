@@ -14,11 +14,15 @@ Rectangle {
     readonly property string provider: wallpaper.configuration.Provider
     readonly property string category: wallpaper.configuration.Category
     readonly property string identifier: provider === 'unsplash' && category ? provider + ':' + category : provider
+    // Only the path of the cached picture is handed over, the picture itself
+    // is loaded asynchronously and shared through the pixmap cache.
+    readonly property string fileSource: 'file:' + identifier
+    readonly property var picture: engine.data[fileSource] || {}
 
     PlasmaCore.DataSource {
         id: engine
         engine: "potd"
-        connectedSources: [identifier]
+        connectedSources: [root.fileSource]
     }
 
     Rectangle {
@@ -30,10 +34,23 @@ Rectangle {
         }
     }
 
+    // tiny version of the picture, available right away
     QImageItem {
         anchors.fill: parent
-        image: engine.data[identifier].Image
+        image: root.picture.Placeholder
         fillMode: wallpaper.configuration.FillMode
         smooth: true
+        visible: pictureImage.status !== Image.Ready
+    }
+
+    Image {
+        id: pictureImage
+        anchors.fill: parent
+        // the url carries the hash, so a new picture in the same file is not taken from the cache
+        source: root.picture.Source || ''
+        fillMode: wallpaper.configuration.FillMode
+        asynchronous: true
+        cache: true
+        smooth: true
     }
 }